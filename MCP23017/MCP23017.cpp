@@ -19,19 +19,29 @@
 #include "MCP23017.h"
 #include "mbed.h"
 
-union {
-    uint8_t  value8[2];
-    uint16_t value16;
-} tmp_data;
-
 /*-----------------------------------------------------------------------------
  *
  */
 MCP23017::MCP23017(PinName sda, PinName scl, int i2cAddress)  : _i2c(sda, scl) {
     MCP23017_i2cAddress = i2cAddress;
+    _window = 0;
+    _int = NULL;
+    _int_pending = false;
+    _interrupts = 0;
+    _event_thread = NULL;
+    _event_signals = 0;
+    for (int pin = 0; pin < MCP23017_PINS; pin++) {
+        _callbacks[pin] = NULL;
+        _callback_args[pin] = NULL;
+    }
+    reset_counters();
     reset();                                  // initialise chip to power-on condition
 }
 
+MCP23017::~MCP23017() {
+    delete _int;
+}
+
 /*-----------------------------------------------------------------------------
  * reset
  * Set configuration (IOCON) and direction(IODIR) registers to initial state
@@ -52,12 +62,20 @@ void MCP23017::reset() {
         writeRegister(reg_addr, (unsigned short)0x0000);
     }
 //
+// Byte mode: 16-bit accesses still cover an A/B pair, and write_sequence
+// can stream values to one port
+//
+    writeRegister(IOCON, (unsigned short)((IOCON_SEQOP << 8) | IOCON_SEQOP));
+//
 // Set the shadow registers to power-on state
 //
     shadow_IODIR = 0xFFFF;
     shadow_GPIO  = 0;
     shadow_GPPU  = 0;
     shadow_IPOL  = 0;
+    _inputs      = 0;
+    _pending     = false;
+    _int_enabled = 0;
 }
 
 /*-----------------------------------------------------------------------------
@@ -65,20 +83,241 @@ void MCP23017::reset() {
  * Write a 1/0 to a single bit of the 16-bit port
  */
 void MCP23017::write_bit(int value, int bit_number) {
-    if (value == 0) {
-        shadow_GPIO &= ~(1 << bit_number);
-    } else {
-        shadow_GPIO |= 1 << bit_number;
-    }
-    writeRegister(GPIO, (unsigned short)shadow_GPIO);
+    update_GPIO(value ? 1 << bit_number : 0, 1 << bit_number);
 }
 
 /*-----------------------------------------------------------------------------
  * Write a combination of bits to the 16-bit port
  */
 void MCP23017::write_mask(unsigned short data, unsigned short mask) {
-    shadow_GPIO = (shadow_GPIO & ~mask) | data;
-    writeRegister(GPIO, (unsigned short)shadow_GPIO);
+    update_GPIO(data, mask);
+}
+
+/*-----------------------------------------------------------------------------
+ * write_sequence
+ * Stream port A states in one transaction: GPIOA, GPIOB, GPIOA, ...
+ */
+void MCP23017::write_sequence(const unsigned char *states, int count) {
+    char  buffer[1 + 2 * MAX_SEQUENCE];
+
+    _bus.lock();
+    char  port_b = shadow_GPIO >> 8;
+    while (count > 0) {
+        int chunk = count < MAX_SEQUENCE ? count : MAX_SEQUENCE;
+        int length = 0;
+
+        buffer[length++] = GPIO;
+        for (int i = 0; i < chunk; i++) {
+            if (i > 0) {
+                buffer[length++] = port_b;
+            }
+            buffer[length++] = states[i];
+        }
+        if (chunk == 1 && _pending) {
+            buffer[length++] = port_b;  // a lone state carries no port B
+        }
+        _i2c.write(MCP23017_i2cAddress, buffer, length);
+        _transactions++;
+        if (length > 2) {
+            _pending = false;       // port B went out with the states
+        }
+
+        shadow_GPIO = (shadow_GPIO & 0xFF00) | states[chunk - 1];
+        states += chunk;
+        count -= chunk;
+    }
+    _bus.unlock();
+}
+
+/*-----------------------------------------------------------------------------
+ * read_latch
+ */
+unsigned short MCP23017::read_latch() {
+    return shadow_GPIO;
+}
+
+/*-----------------------------------------------------------------------------
+ * begin_writes
+ * Output changes stay in shadow_GPIO until the outermost end_writes().
+ * The window holds _bus, so no other thread writes in between.
+ */
+void MCP23017::begin_writes() {
+    _bus.lock();
+    _window++;
+}
+
+/*-----------------------------------------------------------------------------
+ * end_writes
+ */
+void MCP23017::end_writes() {
+    if (_window == 0) {
+        return;
+    }
+    if (--_window == 0 && _pending) {
+        _pending = false;
+        writeRegister(GPIO, (unsigned short)shadow_GPIO);
+    }
+    _bus.unlock();
+}
+
+/*-----------------------------------------------------------------------------
+ * counters
+ */
+unsigned int MCP23017::get_transactions() {
+    return _transactions;
+}
+
+unsigned int MCP23017::get_reads_avoided() {
+    return _reads_avoided;
+}
+
+unsigned int MCP23017::get_writes_avoided() {
+    return _writes_avoided;
+}
+
+void MCP23017::reset_counters() {
+    _transactions = 0;
+    _reads_avoided = 0;
+    _writes_avoided = 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * sample
+ * Inputs come from the chip, outputs from shadow_GPIO, so a read never
+ * disturbs the latch copy. No I2C access when the mask covers outputs only.
+ */
+unsigned short MCP23017::sample(unsigned short mask) {
+    _bus.lock();
+    if ((mask & shadow_IODIR) == 0) {
+        _reads_avoided++;
+    } else {
+        _inputs = readRegister(GPIO);
+    }
+    unsigned short value = ((_inputs & shadow_IODIR) | (shadow_GPIO & ~shadow_IODIR)) & mask;
+    _bus.unlock();
+    return value;
+}
+
+/*-----------------------------------------------------------------------------
+ * update_GPIO
+ * Sets the bits of data under mask in the latch and writes it, unless it
+ * is unchanged or a window is open. _bus covers the read-modify-write, so
+ * writers in other threads never drop each other's bits.
+ */
+void MCP23017::update_GPIO(unsigned short data, unsigned short mask) {
+    _bus.lock();
+    unsigned short value = (shadow_GPIO & ~mask) | data;
+    if (value == shadow_GPIO) {
+        _writes_avoided++;
+    } else {
+        shadow_GPIO = value;
+        if (_window > 0) {
+            if (_pending) {
+                _writes_avoided++;
+            }
+            _pending = true;
+        } else {
+            writeRegister(GPIO, (unsigned short)shadow_GPIO);
+        }
+    }
+    _bus.unlock();
+}
+
+/*-----------------------------------------------------------------------------
+ * interrupt_enable
+ * DEFVAL and INTCON first, so GPINTEN never arms a half configured pin.
+ * The GPIO read clears stale flags and gives service() its reference.
+ */
+void MCP23017::interrupt_enable(unsigned short mask, unsigned short compare, unsigned short defval) {
+    writeRegister(DEFVAL, defval);
+    writeRegister(INTCON, compare);
+    _int_enabled |= mask;
+    writeRegister(GPINTEN, _int_enabled);
+    _inputs = readRegister(GPIO);
+}
+
+/*-----------------------------------------------------------------------------
+ * interrupt_disable
+ */
+void MCP23017::interrupt_disable(unsigned short mask) {
+    _int_enabled &= ~mask;
+    writeRegister(GPINTEN, _int_enabled);
+}
+
+/*-----------------------------------------------------------------------------
+ * interrupt_attach
+ */
+void MCP23017::interrupt_attach(PinName pin) {
+    writeRegister(IOCON, (unsigned short)(((IOCON_MIRROR | IOCON_SEQOP) << 8) | IOCON_MIRROR | IOCON_SEQOP));
+    delete _int;
+    _int = new InterruptIn(pin);
+    _int->mode(PullUp);
+    _int->fall(this, &MCP23017::int_irq);
+}
+
+/*-----------------------------------------------------------------------------
+ * attach
+ */
+void MCP23017::attach(int pin, MCP23017_callback callback, void const *arg) {
+    _callback_args[pin] = arg;
+    _callbacks[pin] = callback;
+}
+
+/*-----------------------------------------------------------------------------
+ * signal
+ */
+void MCP23017::signal(Thread *thread, int32_t signals) {
+    _event_signals = signals;
+    _event_thread = thread;
+}
+
+/*-----------------------------------------------------------------------------
+ * int_irq
+ * INTA falling edge: no I2C in interrupt context, only flag and wake
+ */
+void MCP23017::int_irq() {
+    _interrupts++;
+    _int_pending = true;
+    if (_event_thread) {
+        _event_thread->signal_set(_event_signals);
+    }
+}
+
+/*-----------------------------------------------------------------------------
+ * service
+ */
+unsigned short MCP23017::service() {
+    if (!_int_pending) {
+        return 0;
+    }
+    _int_pending = false;
+
+    _bus.lock();
+    unsigned short capture = readRegister(INTCAP);
+    unsigned short changed = (capture ^ _inputs) & _int_enabled & shadow_IODIR;
+    _inputs = capture;
+    _bus.unlock();
+
+    for (int pin = 0; pin < MCP23017_PINS; pin++) {
+        if ((changed & (1 << pin)) && _callbacks[pin]) {
+            _callbacks[pin](pin, (capture >> pin) & 0x0001, _callback_args[pin]);
+        }
+    }
+//
+// INTA low again means a new change (or a compare mismatch) after the
+// capture: its edge may have been missed, so run again
+//
+    if (_int && _int->read() == 0 && !_int_pending) {
+        int_irq();
+    }
+    return changed;
+}
+
+/*-----------------------------------------------------------------------------
+ * get_interrupts
+ */
+unsigned int MCP23017::get_interrupts() {
+    return _interrupts;
 }
 
 /*-----------------------------------------------------------------------------
@@ -86,16 +325,14 @@ void MCP23017::write_mask(unsigned short data, unsigned short mask) {
  * Read a single bit from the 16-bit port
  */
 int  MCP23017::read_bit(int bit_number) {
-    shadow_GPIO = readRegister(GPIO);
-    return  ((shadow_GPIO >> bit_number) & 0x0001);
+    return  ((sample(1 << bit_number) >> bit_number) & 0x0001);
 }
 
 /*-----------------------------------------------------------------------------
  * read_mask
  */
 int  MCP23017::read_mask(unsigned short mask) {
-    shadow_GPIO = readRegister(GPIO);
-    return (shadow_GPIO & mask);
+    return sample(mask);
 }
 
 /*-----------------------------------------------------------------------------
@@ -120,7 +357,10 @@ void MCP23017::writeRegister(int regAddress, unsigned char data) {
 
     buffer[0] = regAddress;
     buffer[1] = data;
+    _bus.lock();
     _i2c.write(MCP23017_i2cAddress, buffer, 2);
+    _transactions++;
+    _bus.unlock();
 }
 
 /*----------------------------------------------------------------------------
@@ -131,11 +371,13 @@ void MCP23017::writeRegister(int regAddress, unsigned short data) {
     char  buffer[3];
 
     buffer[0] = regAddress;
-    tmp_data.value16 = data;
-    buffer[1] = tmp_data.value8[0];
-    buffer[2] = tmp_data.value8[1];
+    buffer[1] = data & 0xFF;
+    buffer[2] = data >> 8;
 
+    _bus.lock();
     _i2c.write(MCP23017_i2cAddress, buffer, 3);
+    _transactions++;
+    _bus.unlock();
 }
 
 /*-----------------------------------------------------------------------------
@@ -145,8 +387,11 @@ int MCP23017::readRegister(int regAddress) {
     char buffer[2];
 
     buffer[0] = regAddress;
+    _bus.lock();
     _i2c.write(MCP23017_i2cAddress, buffer, 1);
     _i2c.read(MCP23017_i2cAddress, buffer, 2);
+    _transactions += 2;
+    _bus.unlock();
 
     return ((int)(buffer[0] + (buffer[1]<<8)));
 }
@@ -155,20 +400,21 @@ int MCP23017::readRegister(int regAddress) {
  * pinMode
  */
 void MCP23017::pinMode(int pin, int mode) {
-    if (DIR_INPUT) {
+    _bus.lock();
+    if (mode == DIR_INPUT) {
         shadow_IODIR |= 1 << pin;
     } else {
         shadow_IODIR &= ~(1 << pin);
     }
     writeRegister(IODIR, (unsigned short)shadow_IODIR);
+    _bus.unlock();
 }
 
 /*-----------------------------------------------------------------------------
  * digitalRead
  */
 int MCP23017::digitalRead(int pin) {
-    shadow_GPIO = readRegister(GPIO);
-    if ( shadow_GPIO & (1 << pin)) {
+    if (sample(1 << pin)) {
         return 1;
     } else {
         return 0;
@@ -183,13 +429,12 @@ void MCP23017::digitalWrite(int pin, int val) {
     //enable the internal pullup
     //otherwise, it will set the OUTPUT voltage
     //as appropriate.
+    _bus.lock();
     bool isOutput = !(shadow_IODIR & 1<<pin);
 
     if (isOutput) {
         //This is an output pin so just write the value
-        if (val) shadow_GPIO |= 1 << pin;
-        else shadow_GPIO &= ~(1 << pin);
-        writeRegister(GPIO, (unsigned short)shadow_GPIO);
+        update_GPIO(val ? 1 << pin : 0, 1 << pin);
     } else {
         //This is an input pin, so we need to enable the pullup
         if (val) {
@@ -199,28 +444,28 @@ void MCP23017::digitalWrite(int pin, int val) {
         }
         writeRegister(GPPU, (unsigned short)shadow_GPPU);
     }
+    _bus.unlock();
 }
 
 /*-----------------------------------------------------------------------------
  * digitalWordRead
  */
 unsigned short MCP23017::digitalWordRead() {
-    shadow_GPIO = readRegister(GPIO);
-    return shadow_GPIO;
+    return sample(0xFFFF);
 }
 
 /*-----------------------------------------------------------------------------
  * digitalWordWrite
  */
 void MCP23017::digitalWordWrite(unsigned short w) {
-    shadow_GPIO = w;
-    writeRegister(GPIO, (unsigned short)shadow_GPIO);
+    update_GPIO(w, 0xFFFF);
 }
 
 /*-----------------------------------------------------------------------------
  * inputPolarityMask
  */
 void MCP23017::inputPolarityMask(unsigned short mask) {
+    shadow_IPOL = mask;
     writeRegister(IPOL, mask);
 }
 
@@ -20,6 +20,7 @@
 #define     MBED_MCP23017_H
 
 #include    "mbed.h"
+#include    "rtos.h"
 
 //
 // Register defines from data sheet - we set IOCON.BANK to 0
@@ -37,11 +38,29 @@
 #define     GPIO        0x12
 #define     OLAT        0x14
 
+//
+// IOCON bits
+//
+#define     IOCON_MIRROR    0x40    // 1 = INTA and INTB both report changes on either port
+#define     IOCON_SEQOP     0x20    // 1 = byte mode, pointer toggles within an A/B pair
+
 #define     I2C_BASE_ADDRESS    0x40
 
 #define     DIR_OUTPUT      0
 #define     DIR_INPUT       1
 
+#define     MAX_SEQUENCE    48      // port A states per write_sequence transaction
+
+#define     MCP23017_PINS   16
+
+/** Input change callback
+ *
+ * @param   pin     bit number range 0 --> 15
+ * @param   value   level captured when the interrupt fired
+ * @param   arg     as given to attach()
+ */
+typedef void (*MCP23017_callback)(int pin, int value, void const *arg);
+
 /** MCP23017 class
  *
  * Allow access to an I2C connected MCP23017 16-bit I/O extender chip
@@ -63,6 +82,8 @@ public:
      */
     MCP23017(PinName sda, PinName scl, int i2cAddress);
 
+    ~MCP23017();
+
     /** Reset MCP23017 device to its power-on state
      */    
     void reset(void);
@@ -132,11 +153,140 @@ public:
     void internalPullupMask(unsigned short mask);
     int read(void);
     void write(int data);
+    
+    /** Write successive values to port A in a single I2C transaction
+     *
+     * Relies on IOCON.SEQOP byte mode (set by reset()): the address pointer
+     * toggles between GPIOA and GPIOB, so every A value is followed by the
+     * unchanged B value. Each state is held for two I2C byte times.
+     * Longer sequences are split in chunks of MAX_SEQUENCE states.
+     * Port B bits left pending by a write window go out with the first
+     * chunk, after its first state even when it is the only one.
+     *
+     * @param   states  port A values, in order
+     * @param   count   number of values
+     */
+    void write_sequence(const unsigned char *states, int count);
+    
+    /** Last value written to the outputs, no I2C access
+     *
+     * @return  16-bit output latch copy
+     */
+    unsigned short read_latch(void);
+
+    /** Open a write window
+     *
+     * write_bit, write_mask, digitalWrite and digitalWordWrite only update
+     * the latch copy until the matching end_writes(), which sends it in a
+     * single 16-bit GPIO write. Windows nest; write_sequence sends any
+     * pending bits along with its own states.
+     *
+     * The window holds the bus lock: writers in other threads wait for
+     * end_writes(), so a latch value read inside it (read_latch) stays
+     * valid until it is written back.
+     */
+    void begin_writes(void);
+
+    /** Close a write window, writing GPIO once if anything changed
+     */
+    void end_writes(void);
+
+    /** I2C transactions issued, a register read counts two
+     */
+    unsigned int get_transactions(void);
+
+    /** Input reads served without an I2C access (output pins only)
+     */
+    unsigned int get_reads_avoided(void);
+
+    /** GPIO writes saved, either coalesced in a window or unchanged
+     */
+    unsigned int get_writes_avoided(void);
+
+    /** Zero the three counters
+     */
+    void reset_counters(void);
+
+    /** Enable change interrupts on input pins
+     *
+     * A pin interrupts when it differs from its previous level, or with
+     * its compare bit set, whenever it differs from its defval bit (the
+     * interrupt then repeats for as long as the level differs).
+     *
+     * @param   mask        pins to enable
+     * @param   compare     pins compared against defval (INTCON)
+     * @param   defval      reference levels (DEFVAL)
+     */
+    void interrupt_enable(unsigned short mask, unsigned short compare = 0, unsigned short defval = 0);
+
+    /** Disable change interrupts
+     *
+     * @param   mask        pins to disable
+     */
+    void interrupt_disable(unsigned short mask);
+
+    /** Watch the INTA output with an InterruptIn
+     *
+     * Sets IOCON.MIRROR so INTA covers both ports. INTA is active low.
+     *
+     * @param   pin         mbed pin wired to INTA
+     */
+    void interrupt_attach(PinName pin);
+
+    /** Per-pin change callback, run by service()
+     *
+     * @param   pin         bit number range 0 --> 15
+     * @param   callback    NULL for none
+     * @param   arg         passed to callback
+     */
+    void attach(int pin, MCP23017_callback callback, void const *arg);
+
+    /** Event mode: signal a thread from the INTA interrupt
+     *
+     * The thread blocks in Thread::signal_wait() and calls service()
+     * once woken; nothing polls the bus in between.
+     *
+     * @param   thread      thread to signal, NULL for none
+     * @param   signals     flags to set
+     */
+    void signal(Thread *thread, int32_t signals);
+
+    /** Handle a pending interrupt in thread context
+     *
+     * Reads INTCAP once, which also clears the interrupt, and runs the
+     * callback of every enabled pin whose captured level changed. Costs
+     * no I2C access when no interrupt is pending.
+     *
+     * @return  pins that changed
+     */
+    unsigned short service(void);
+
+    /** INTA interrupts received
+     */
+    unsigned int get_interrupts(void);
 
 protected:
+    unsigned short sample(unsigned short mask);
+    void update_GPIO(unsigned short data, unsigned short mask);
+    void int_irq(void);
+
     I2C     _i2c;
     int     MCP23017_i2cAddress;                        // physical I2C address
     unsigned short   shadow_GPIO, shadow_IODIR, shadow_GPPU, shadow_IPOL;     // Cached copies of the register values
+    unsigned short   _inputs;                           // last GPIO read
+    int     _window;                                    // begin_writes() nesting depth
+    bool    _pending;                                   // shadow_GPIO not yet written
+    unsigned int     _transactions, _reads_avoided, _writes_avoided;
+    Mutex   _bus;                                       // transfers and shadow read-modify-writes, recursive
+
+    InterruptIn         *_int;                          // INTA, NULL until interrupt_attach()
+    volatile bool       _int_pending;
+    volatile unsigned int _interrupts;
+    unsigned short      _int_enabled;                   // shadow of GPINTEN
+    Thread              *_event_thread;
+    int32_t             _event_signals;
+    MCP23017_callback   _callbacks[MCP23017_PINS];
+    void const          *_callback_args[MCP23017_PINS];
     
 };
 
@@ -7,6 +7,7 @@
 #include "MCP23017.h"
 
 #include "mbed.h"
+#include "us_ticker_api.h"
 
 /*
  * Initialisation
@@ -50,17 +51,27 @@ WattBob_TextLCD::WattBob_TextLCD(MCP23017 *port) {
     par_port = port;
     par_port->config(0x0F00, 0x0F00, 0x0F00);
     
-    _rows = 2;
-    _columns = 16;
+    _rows = DISPLAY_ROWS;
+    _columns = DISPLAY_COLUMNS;
+    _row = 0;
+    _column = 0;
+    _buffered = false;
+    _polling = false;
+    _chars = 0;
+    _char_us = 0;
+    _char_us_max = 0;
+    _clear_us = 0;
 
     // 
     // Time to allow unit to initialise
     //
      wait(DISPLAY_INIT_DELAY_SECS); 
      
+    par_port->begin_writes();
     _rw(0);
     _e(0);
     _rs(0); // command mode
+    par_port->end_writes();
     
     //
     // interface defaults to an 8-bit interface. However, we need to ensure that we
@@ -82,19 +93,65 @@ WattBob_TextLCD::WattBob_TextLCD(MCP23017 *port) {
     writeCommand(CMD_FUNCTION_SET | INTERFACE_4_BIT | TWO_LINE_DISPLAY | FONT_5x8 | ENGL_JAPAN_FONT_SET); //  0x28
     writeCommand(CMD_DISPLAY_CONTROL | DISPLAY_ON | CURSOR_OFF | CURSOR_CHAR_BLINK_OFF); // 0xC0
     cls();
-    writeCommand(CMD_RETURN_HOME);    
+    writeSlowCommand(CMD_RETURN_HOME, DISPLAY_HOME_DELAY);
     writeCommand(CMD_ENTRY_MODE | CURSOR_STEP_RIGHT | DISPLAY_SHIFT_OFF );  // 0x06
 }
 
 int WattBob_TextLCD::_putc(int value) {
     if(value == '\n') {
         newline();
+    } else if(_buffered) {
+        _frame[_row][_column] = value;
+        _column++;
+        if(_column >= _columns) {
+            newline();
+        }
     } else {
+        _frame[_row][_column] = value;
+        _screen[_row][_column] = value;
         writeData(value);
     }
     return value;
 }
 
+void WattBob_TextLCD::setBuffered(bool buffered) {
+    if(_buffered && !buffered) {
+        flush();
+        _buffered = false;
+        locate(_row, _column);      // put the display cursor back
+    }
+    _buffered = buffered;
+}
+
+int WattBob_TextLCD::flush() {
+    int written = 0;
+    for(int row = 0; row < _rows; row++) {
+        int column = 0;
+        while(column < _columns) {
+            if(_frame[row][column] == _screen[row][column]) {
+                column++;
+                continue;
+            }
+            // one address command per run, the display auto-increments
+            writeCommand(CMD_SET_DDRAM_ADDRESS + (row * 0x40) + column);
+            int start = column;
+            while(column < _columns && _frame[row][column] != _screen[row][column]) {
+                _screen[row][column] = _frame[row][column];
+                column++;
+            }
+            writeBytes(&_frame[row][start], column - start, 1);
+            written += column - start;
+        }
+    }
+    return written;
+}
+
+void WattBob_TextLCD::write(const char *text, int length) {
+    for (int i = 0; i < length; i++) {
+        _putc(text[i]);
+    }
+}
+
 int WattBob_TextLCD::_getc() {
     return 0;
 }
@@ -105,7 +162,7 @@ void WattBob_TextLCD::newline() {
     if(_row >= _rows) {
         _row = 0;
     }
-    locate(_column, _row); 
+    locate(_row, _column); 
 }
 
 void WattBob_TextLCD::locate(int row, int column) {
@@ -116,16 +173,84 @@ void WattBob_TextLCD::locate(int row, int column) {
     
     _row = row;
     _column = column;
+    if(_buffered) {
+        return;                       // the cursor is only moved by flush()
+    }
     int address = 0x80 + (_row * 0x40) + _column; // memory starts at 0x80, and internally it is 40 chars per row (only first 16 used)
     writeCommand(address);            
 }
 
 void WattBob_TextLCD::cls() {
-    writeCommand(CMD_CLEAR_DISPLAY);  // 0x01
-    wait(DISPLAY_CLEAR_DELAY);                    // 
+    memset(_frame, ' ', sizeof(_frame));
+    if(_buffered) {
+        locate(0, 0);
+        return;                       // cleared by the next flush()
+    }
+    memset(_screen, ' ', sizeof(_screen));
+    unsigned int start = us_ticker_read();
+    writeSlowCommand(CMD_CLEAR_DISPLAY, DISPLAY_CLEAR_DELAY);  // 0x01
+    _clear_us = us_ticker_read() - start;
     locate(0, 0);
 }
 
+/*
+ * Clear and home run for milliseconds: wait on the busy flag, or for the
+ * fixed delay when polling is off or the flag never drops.
+ */
+void WattBob_TextLCD::writeSlowCommand(int command, float delay) {
+    writeCommand(command);
+    if(!_polling || !waitReady()) {
+        wait(delay);
+    }
+}
+
+void WattBob_TextLCD::setBusyPolling(bool polling) {
+    _polling = polling;
+}
+
+/*
+ * Busy flag read in 4-bit mode: D4-D7 become inputs, RW goes high, the
+ * first E pulse returns BF on D7, the second one the low address nibble
+ * which is discarded. The data lines are only driven again once RW is low.
+ */
+bool WattBob_TextLCD::waitReady() {
+    par_port->begin_writes();         // no other writer until base goes back
+    unsigned char base = par_port->read_latch() & ~(0x0F | (1 << E_BIT) | (1 << RS_BIT));
+    unsigned char read = base | (1 << RW_BIT);
+    unsigned char high[2] = { read, (unsigned char)(read | (1 << E_BIT)) };
+    unsigned char low[3] = { read, (unsigned char)(read | (1 << E_BIT)), read };
+    unsigned int start = us_ticker_read();
+    bool busy = true;
+
+    unsigned short dir = 0x0F00;      // as configured by the constructor
+    par_port->inputOutputMask(dir | 0x000F);
+    while(busy) {
+        par_port->write_sequence(high, 2);
+        busy = par_port->readRegister(GPIO) & 0x0008;
+        par_port->write_sequence(low, 3);
+        if(!busy || us_ticker_read() - start >= DISPLAY_BUSY_TIMEOUT_US) {
+            break;
+        }
+        Thread::yield();
+    }
+    par_port->write_sequence(&base, 1);
+    par_port->inputOutputMask(dir);
+    par_port->end_writes();
+    return !busy;
+}
+
+int WattBob_TextLCD::charLatency() {
+    return _chars ? _char_us / _chars : 0;
+}
+
+int WattBob_TextLCD::charLatencyMax() {
+    return _char_us_max;
+}
+
+int WattBob_TextLCD::clearLatency() {
+    return _clear_us;
+}
+
 void WattBob_TextLCD::reset() {
     cls();
 }
@@ -142,19 +267,61 @@ void WattBob_TextLCD::writeNibble(int value) {
     clock();
 }
 
-void WattBob_TextLCD::writeByte(int value) {
-    writeNibble((value >> 4) & 0x000F);
-    writeNibble((value >> 0) & 0x000F);
+void WattBob_TextLCD::writeByte(int value, int rs) {
+    char byte = value;
+    writeBytes(&byte, 1, rs);
+}
+
+/*
+ * Each nibble is three port A states: data with E low, E high, E low.
+ * The display latches on the falling edge; every state lasts two I2C
+ * byte times (>= 45us at 400kHz), longer than the E pulse width and the
+ * 40us execution time, so no explicit waits are needed.
+ */
+void WattBob_TextLCD::writeBytes(const char *values, int length, int rs) {
+    unsigned char states[MAX_SEQUENCE];
+    par_port->begin_writes();         // no other writer until base goes back
+    unsigned char base = par_port->read_latch() & ~(0x0F | (1 << E_BIT) | (1 << RW_BIT) | (1 << RS_BIT));
+    int count = 0;
+
+    unsigned int start = us_ticker_read();
+
+    if(rs) {
+        base |= 1 << RS_BIT;
+    }
+    for(int i = 0; i < length; i++) {
+        unsigned char nibbles[2] = { (unsigned char)((values[i] >> 4) & 0x0F), (unsigned char)(values[i] & 0x0F) };
+        for(int n = 0; n < 2; n++) {
+            states[count++] = base | nibbles[n];
+            states[count++] = base | nibbles[n] | (1 << E_BIT);
+            states[count++] = base | nibbles[n];
+        }
+        if(count + 6 > MAX_SEQUENCE) {
+            par_port->write_sequence(states, count);
+            count = 0;
+        }
+    }
+    if(count) {
+        par_port->write_sequence(states, count);
+    }
+    par_port->end_writes();
+
+    if(rs && length > 0) {
+        unsigned int per_char = (us_ticker_read() - start) / length;
+        _chars += length;
+        _char_us += per_char * length;
+        if(per_char > _char_us_max) {
+            _char_us_max = per_char;
+        }
+    }
 }
 
 void WattBob_TextLCD::writeCommand(int command) {
-    _rs(0);
-    writeByte(command);
+    writeByte(command, 0);
 }
 
 void WattBob_TextLCD::writeData(int data) {
-    _rs(1);
-    writeByte(data);
+    writeByte(data, 1);
     _column++;
     if(_column >= _columns) {
         newline();
@@ -6,6 +6,7 @@
 #define WATTBOB_TEXTLCD_H
 
 #include "mbed.h"
+#include "rtos.h"
 #include "Stream.h"
 #include "MCP23017.h"
 
@@ -73,11 +74,28 @@
 //
 #define     DISPLAY_INIT_DELAY_SECS    0.5f       // 500mS
 #define     DISPLAY_CLEAR_DELAY        0.01f      // 10 mS (spec is 6.2mS)
+#define     DISPLAY_HOME_DELAY         0.002f     // 2 mS (spec is 1.52mS)
+#define     DISPLAY_BUSY_TIMEOUT_US    20000      // give up polling after 20 mS
+#define     DISPLAY_ROWS               2
+#define     DISPLAY_COLUMNS            16
 
 /** Class to access 16*2 LCD display connected to an MCP23017 I/O extender chip
  *
  * Derived from the "stream" class to be able to use methods such as "printf"
  *
+ * A shadow copy of the 2*16 characters is kept in RAM. In buffered mode
+ * printf/locate/cls only update that copy and flush() sends the cells
+ * that differ from what the display shows, one locate per run of
+ * changed cells, so an unchanged screen costs no I2C traffic at all.
+ *
+ * Bytes are sent with MCP23017::write_sequence: the RS, data and E
+ * states of both nibbles of a character (or a run of characters) go out
+ * in one I2C transaction, timed by the bus itself.
+ *
+ * With busy polling enabled, clear and home wait on the HD44780 busy flag
+ * (read back through the MCP23017 with RW high) instead of a fixed delay,
+ * yielding to other threads between polls.
+ *
  * Example :
  * @code
  * .....
@@ -127,6 +145,56 @@ public:
      * Virtual function for stream class
      */             
     virtual void reset();
+
+    /** Select buffered or immediate output
+     *
+     * Leaving buffered mode flushes the pending changes
+     *
+     * @param   buffered    true to only update RAM until flush()
+     */
+    void setBuffered(bool buffered);
+
+    /** Send the cells changed since the last flush to the display
+     *
+     * @return  number of characters written
+     */
+    int flush();
+
+    /** Select busy flag polling or fixed delays for slow commands
+     *
+     * @param   polling     true to poll the busy flag
+     */
+    void setBusyPolling(bool polling);
+
+    /** Wait until the display is ready for the next instruction
+     *
+     * Polls the busy flag, calling Thread::yield() between reads
+     *
+     * @return  false if still busy after DISPLAY_BUSY_TIMEOUT_US
+     */
+    bool waitReady();
+
+    /** Timing instrumentation
+     *
+     * @return  average and worst time to send one character, in us
+     */
+    int charLatency();
+    int charLatencyMax();
+
+    /** Timing instrumentation
+     *
+     * @return  time taken by the last cls(), in us
+     */
+    int clearLatency();
+
+    /** Write characters at the cursor position
+     *
+     * Goes straight to the display, without the stdio layer of printf/puts
+     *
+     * @param   text    characters to write, need not be terminated
+     * @param   length  number of characters
+     */
+    void write(const char *text, int length);
         
 protected:
 
@@ -137,7 +205,9 @@ protected:
     void clock();
     void writeData(int data);
     void writeCommand(int command);
-    void writeByte(int value);
+    void writeSlowCommand(int command, float delay);
+    void writeByte(int value, int rs);
+    void writeBytes(const char *values, int length, int rs);
     void writeNibble(int value);
     
     void _rs (int data);
@@ -150,6 +220,16 @@ protected:
     int _row;
     int _column;   
     
+    bool _buffered;
+    bool _polling;
+    
+    unsigned int _chars;        // characters sent
+    unsigned int _char_us;      // total time spent sending them
+    unsigned int _char_us_max;  // worst time for a single character
+    unsigned int _clear_us;     // last cls() duration
+    char _frame[DISPLAY_ROWS][DISPLAY_COLUMNS];     // wanted contents
+    char _screen[DISPLAY_ROWS][DISPLAY_COLUMNS];    // contents on the display
+    
 private:
     MCP23017    *par_port; 
 };
@@ -0,0 +1,142 @@
+//************************************************************************
+//
+//  asyncserial.cpp
+//
+//  AsyncSerial Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "asyncserial.h"
+
+/*  Default Constructor */
+//  @param  tx, rx  UART pins
+//
+//  @brief  Hooks the TX empty interrupt
+AsyncSerial::AsyncSerial(PinName tx, PinName rx)
+: serial(tx, rx),
+  buffer(RING_DROP_NEWEST),
+  sending(false),
+  overflows(0),
+  on_done(NULL),
+  done_arg(NULL)
+{
+    serial.attach(this, &AsyncSerial::txIrq, RawSerial::TxIrq);
+}
+
+/*  Standard Accessor */
+void AsyncSerial::baud(int baudrate)
+{
+    serial.baud(baudrate);
+}
+
+/*  Queues bytes for transmission */
+//  @param  data    bytes to send
+//  @param  length  number of bytes
+//  @return bytes accepted, less than length if the ring is full
+//
+//  N.B.: never waits on the UART
+size_t AsyncSerial::write(const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t*)data;
+    size_t queued = 0;
+
+    while (queued < length && buffer.put(bytes[queued]))
+        queued++;
+    overflows += length - queued;
+
+    // Kick an idle transmitter, the interrupt takes over from there
+    __disable_irq();
+    if (!sending && queued)
+    {
+        sending = true;
+        fill();
+    }
+    __enable_irq();
+
+    return queued;
+}
+
+/*  Completion callback */
+//  @param  done    called once every queued byte went to the UART,
+//                  NULL for none
+//  @param  arg     passed to done
+//
+//  N.B.: runs in interrupt context, or from write() if the bytes fit
+//        straight into the FIFO
+void AsyncSerial::attach(void (*done)(void const *p), void const *arg)
+{
+    on_done = done;
+    done_arg = arg;
+}
+
+/*  Standard Accessor */
+//  @return bytes write() can accept right now
+uint32_t AsyncSerial::space()
+{
+    return buffer.capacity() - buffer.size();
+}
+
+/*  Standard Accessor */
+//  @return true while bytes are still waiting for the FIFO
+bool AsyncSerial::busy()
+{
+    return sending;
+}
+
+/*  Polled input */
+//  @return true if a received character is waiting
+bool AsyncSerial::readable()
+{
+    return serial.readable();
+}
+
+/*  Polled input */
+//  @return next received character
+//
+//  N.B.: blocks until one arrives, check readable() first
+int AsyncSerial::getc()
+{
+    return serial.getc();
+}
+
+/*  Standard Accessor */
+//  @return bytes rejected by write()
+uint32_t AsyncSerial::getOverflows()
+{
+    return overflows;
+}
+
+/*  Standard Accessor */
+//  @return largest number of bytes ever waiting in the ring
+uint32_t AsyncSerial::getHighWater()
+{
+    return buffer.getHighWater();
+}
+
+/*  TX empty interrupt */
+void AsyncSerial::txIrq()
+{
+    if (sending)
+        fill();
+}
+
+/*  Moves bytes from the ring to the FIFO */
+//  @brief  stops when the FIFO is full, goes idle when the ring is empty
+//
+//  N.B.: called with the TX interrupt unable to run
+void AsyncSerial::fill()
+{
+    uint8_t c;
+    while (serial.writeable())
+    {
+        if (!buffer.get(c))
+        {
+            sending = false;
+            if (on_done)
+                on_done(done_arg);
+            return;
+        }
+        serial.putc(c);
+    }
+}
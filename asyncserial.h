@@ -0,0 +1,77 @@
+//************************************************************************
+//
+//  asyncserial.h
+//
+//  Requirements: mbed.h, ring.h
+//
+//  Defines an AsyncSerial Class: a serial port whose writes return at
+//  once. Bytes are copied into a TX ring and fed to the UART FIFO by the
+//  TX empty interrupt, so no thread ever waits on the baud rate.
+//
+//  The first bytes after an idle period are pushed into the FIFO by
+//  write() itself, as the interrupt only fires once the FIFO drains.
+//
+//  Class members:
+//          -serial         (RawSerial, no stdio locks)
+//          -buffer         (TelemetryRing<uint8_t>, thread -> interrupt)
+//
+//  Methods:
+//          -write          queues bytes, never blocks
+//          -attach         callback run when the ring has drained
+//          -space          room left in the ring
+//          -readable, getc polled input, for console commands
+//
+//************************************************************************
+#ifndef __ASYNCSERIAL_H__
+#define __ASYNCSERIAL_H__
+
+/* Mbed includes */
+#include "mbed.h"
+
+/* Ring includes */
+#include "ring.h"
+
+/* Bytes buffered between write() and the UART */
+#define ASYNC_SERIAL_BUFFER     512
+
+class AsyncSerial
+{
+    public:
+        /* Default Constructor */
+        AsyncSerial(PinName tx, PinName rx);
+
+        void baud(int baudrate);
+
+        /* Non-blocking output */
+        size_t write(const void *data, size_t length);
+        void attach(void (*done)(void const *p), void const *arg);
+        uint32_t space();
+        bool busy();
+
+        /* Polled input */
+        bool readable();
+        int getc();
+
+        /* Statistics */
+        uint32_t getOverflows();
+        uint32_t getHighWater();
+
+    private:
+        void txIrq();
+        void fill();
+
+        /* Disallow copy */
+        AsyncSerial(const AsyncSerial&);
+        AsyncSerial &operator=(const AsyncSerial&);
+
+    protected:
+        /* Members */
+        RawSerial serial;
+        TelemetryRing<uint8_t, ASYNC_SERIAL_BUFFER> buffer;
+        volatile bool sending;
+        uint32_t overflows;
+        void (*on_done)(void const *p);
+        void const *done_arg;
+};
+
+#endif
@@ -0,0 +1,126 @@
+//************************************************************************
+//
+//  average.h
+//
+//  Defines a MovingAverage Class template: an O(1) filter over the
+//  last N samples (0-255).
+//
+//  Samples are kept in a fixed ring buffer together with their running
+//  sum, so every update replaces the oldest sample and returns a fresh
+//  average without searching, copying or allocating. Until the window
+//  is full the average is taken over the samples seen so far.
+//
+//  In exponential mode the ring is unused and the filter keeps an
+//  8-bit fractional accumulator with a smoothing factor of 1/N.
+//
+//  Class members:
+//          -samples        (uint8_t[N])
+//          -sum            (uint32_t)
+//          -ema            (Q8 accumulator)
+//
+//  Methods:
+//          -update         pushes a sample and returns the new average
+//          -getAverage     last computed average
+//          -reset          empties the window
+//          -setMode        window or exponential moving average
+//
+//************************************************************************
+#ifndef __AVERAGE_H__
+#define __AVERAGE_H__
+
+/* Standard includes */
+#include <stdint.h>
+
+/* Filter modes */
+typedef enum {
+    AVERAGE_WINDOW,
+    AVERAGE_EXPONENTIAL
+} AverageMode;
+
+template<uint32_t N>
+class MovingAverage
+{
+    public:
+        /* Default Constructor */
+        MovingAverage(AverageMode mode = AVERAGE_WINDOW)
+        : mode(mode)
+        {
+            reset();
+        }
+
+        /*  Adds a sample */
+        //  @param  sample  new raw value
+        //  @return average including the new sample
+        unsigned char update(unsigned char sample)
+        {
+            if (mode == AVERAGE_EXPONENTIAL)
+            {
+                // ema += (sample - ema) / N, the first sample seeds it
+                int32_t target = (int32_t)sample << 8;
+                if (count == 0)
+                    ema = target;
+                else
+                    ema += (target - ema) / (int32_t)N;
+                count = 1;
+                average = (unsigned char)((ema + 0x80) >> 8);
+                return average;
+            }
+
+            sum += sample;
+            if (count == N)
+            {
+                // Full window: constant divisor, no division instruction
+                sum -= samples[index];
+                average = (unsigned char)(sum / N);
+            }
+            else
+                average = (unsigned char)(sum / ++count);
+            samples[index] = sample;
+            if (++index == N)
+                index = 0;
+            return average;
+        }
+
+        /*  Standard Accessor */
+        //  @return last average, 0 before the first sample
+        unsigned char getAverage()
+        {
+            return average;
+        }
+
+        /*  Standard Accessor */
+        AverageMode getMode()
+        {
+            return mode;
+        }
+
+        /*  Changes the filter mode */
+        //  @brief  the filter restarts empty
+        void setMode(AverageMode mode)
+        {
+            this->mode = mode;
+            reset();
+        }
+
+        /*  Empties the window */
+        void reset()
+        {
+            index = 0;
+            count = 0;
+            sum = 0;
+            ema = 0;
+            average = 0;
+        }
+
+    protected:
+        /* Members */
+        AverageMode mode;
+        unsigned char samples[N];
+        uint32_t index;
+        uint32_t count;
+        uint32_t sum;
+        int32_t ema;
+        unsigned char average;
+};
+
+#endif
@@ -9,6 +9,9 @@
 /* Header includes */
 #include "car.h"
 
+/* Mbed includes */
+#include "us_ticker_api.h"
+
 /*  Default Constructor */
 //  @brief  Initialize Semaphore, Threads and puts the 
 //          Car object in Off Mode
@@ -24,6 +27,9 @@ _thread(&Car::threadStarter, this, osPriorityNormal,1024)
     left_indicator = 0;
     right_indicator = 0;
     distance = 0;
+    distance_frac = 0;
+    adaptive = 0;
+    setTimeStep(50);
 }
 /*  Standard Accessor */
 char Car::getAcc()
@@ -38,9 +44,10 @@ char Car::getBrake()
 }
 
 /*  Standard Accessor */
+//  @return     integer part of the speed
 char Car::getSpeed()
 {
-     return speed;
+     return speed >> PHYSICS_FRAC_BITS;
 }
 
 /*  Standard Accessor */
@@ -142,7 +149,7 @@ void Car::writeRight(bool Right)
 void Car::writeSpeed(char Speed)
 {
     if (engine)
-        speed = Speed;
+        speed = (int32_t)Speed << PHYSICS_FRAC_BITS;
     else
         speed = 0;
 }
@@ -157,29 +164,121 @@ bool Car::IsItOn()
 //  @rate   20Hz
 //  @brief  updates speed in accords to acceleration and brake value
 //
-//  N.B.:Time delta consistent with repetition rate
+//  N.B.:Time delta consistent with repetition rate, or measured in
+//       adaptive mode
+//  N.B.:Released on a fixed grid (Thread::period_wait), the time spent
+//       waiting for the Pedals and stepping does not stretch the period
 //  N.B.:Uses Semaphore
 void Car::updateSpeed()
 {
+    uint32_t last = us_ticker_read();
+    uint32_t period = step_ms;
+    _thread.period_set(period);
     while(1)
     {
         Pedals.wait();
-        if (engine)
-        {
-            unsigned short test = speed + ((accelerator - brake) * 0.05);
-            if (test < 255)
-            speed = test;
-            else 
-            speed = 255;
-        }
+        uint32_t now = us_ticker_read();
+        if (adaptive)
+            step(physicsTimeStep(now - last));
         else
-            speed = 0;
-        distance = distance + (speed * 0.05);
+            step(step_dt);
+        last = now;
         Pedals.release();
-        Thread::wait(2000);
+
+        // A new time step restarts the release grid
+        if (period != step_ms)
+        {
+            period = step_ms;
+            _thread.period_set(period);
+        }
+        _thread.period_wait();
+    }
+}
+
+/*  Simulation step */
+//  @param  dt  time step in seconds, Q format (see physics.h)
+//  @brief  updates speed and distance in accords to acceleration
+//          and brake value
+//
+//  N.B.:Fixed-point, keeps the fractional speed and distance
+//  N.B.:Does not take the Pedals semaphore
+void Car::step(int32_t dt)
+{
+    if (engine)
+        speed = physicsSpeed(speed, accelerator, brake, dt);
+    else
+        speed = 0;
+    physicsDistance(distance, distance_frac, speed, dt);
+}
+
+/*  Batch simulation */
+//  @param  ticks   number of steps
+//  @param  dt      time step in seconds, Q format
+//
+//  N.B.:Does not take the Pedals semaphore
+void Car::run(uint32_t ticks, int32_t dt)
+{
+    for (uint32_t i = 0; i < ticks; i++)
+        step(dt);
+}
+
+/*  Drive cycle replay */
+//  @param  cycle               pedal samples
+//  @param  samples             number of samples
+//  @param  ticks_per_sample    steps run with each sample
+//  @param  dt                  time step in seconds, Q format
+//
+//  N.B.:Pedals go through writeAcc/writeBrake, so they read 0
+//       while the engine is off
+//  N.B.:Does not take the Pedals semaphore
+void Car::replay(const PedalSample *cycle, uint32_t samples,
+                 uint32_t ticks_per_sample, int32_t dt)
+{
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        writeAcc(cycle[i].accelerator);
+        writeBrake(cycle[i].brake);
+        run(ticks_per_sample, dt);
     }
 }
 
+/*  Standard Accessor */
+//  @param  ms  period of the update thread in ms
+//
+//  @brief  also sets the nominal integration step
+void Car::setTimeStep(uint32_t ms)
+{
+    step_ms = ms;
+    step_dt = physicsTimeStep(ms * 1000);
+}
+
+/*  Standard Accessor */
+uint32_t Car::getTimeStep()
+{
+    return step_ms;
+}
+
+/*  Standard Accessor */
+//  @return releases of the update thread found already past
+uint32_t Car::getOverruns()
+{
+    return _thread.overruns();
+}
+
+/*  Standard Accessor */
+//  @return update thread, for its stack usage
+Thread &Car::getThread()
+{
+    return _thread;
+}
+
+/*  Standard Accessor */
+//  @param  Adaptive    integrate the measured time between updates
+void Car::setAdaptive(bool Adaptive)
+{
+    adaptive = Adaptive;
+}
+
 /*  Turn the Car On */
 //  @brief      sets the Car in ON mode
 void Car::TurnOn()
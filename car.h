@@ -2,7 +2,7 @@
 //
 //  car.h
 //
-//  Requirements: rtos.h
+//  Requirements: rtos.h, physics.h
 //
 //  Defines a Car Class that proviedes a simple simulator of the 
 //  behaviour of a car vehicle.
@@ -10,8 +10,8 @@
 //  Class members:
 //          -accelerator    (uint8_t)
 //          -brake          (uint8_t)
-//          -speed          (uint8_t)
-//          -distance       (uint16_t)
+//          -speed          (Q16.16, see physics.h)
+//          -distance       (uint32_t + Q16.16 fraction)
 //          -engine         (bool)
 //          -side_light     (bool)
 //          -left_indicator (bool)
@@ -21,12 +21,22 @@
 //          -This class provides standard accessors to every member of the class
 //          -Updates Car status in accords to Engine status
 //          -Updates speed and distance in accords to acceleration value
+//           with the fixed-point integrator in physics.h
 //
 //
+//  Simulation engine:
+//          -step           advances speed and distance by an explicit
+//                          time step, independent of the RTOS
+//          -run            steps N ticks in a tight loop
+//          -replay         steps through a drive cycle of pedal samples
+//
 //  Threads: 
 //          This class provides a thread updating speed and distance 
 //          according to accelerator and brake value.
-//          Repetition rate 20Hz
+//          Repetition rate 20Hz (setTimeStep) on a fixed release grid,
+//          with missed releases counted (getOverruns). The integrated
+//          time step is either the nominal period or, in adaptive mode,
+//          the time actually elapsed since the previous update.
 //
 //
 //************************************************************************
@@ -36,6 +46,15 @@
 /* RTOS Includes */
 #include "rtos.h"
 
+/* Integrator includes */
+#include "physics.h"
+
+/* One sample of a drive cycle */
+typedef struct {
+    unsigned char accelerator;
+    unsigned char brake;
+} PedalSample;
+
 class Car
 {
     public:
@@ -63,6 +82,17 @@ class Car
         /* Thread worker */
         void updateSpeed();
         
+        /* Simulation engine */
+        void step(int32_t dt);
+        void run(uint32_t ticks, int32_t dt);
+        void replay(const PedalSample *cycle, uint32_t samples,
+                    uint32_t ticks_per_sample, int32_t dt);
+        void setTimeStep(uint32_t ms);
+        uint32_t getTimeStep();
+        uint32_t getOverruns();
+        Thread &getThread();
+        void setAdaptive(bool Adaptive);
+        
         /* Methods to update car status in accords to the engine value */
         void TurnOn();
         void TurnOff();
@@ -79,13 +109,19 @@ class Car
         /* Members */
         char accelerator;
         char brake;
-        char speed;
-        unsigned short distance;
+        int32_t speed;
+        uint32_t distance;
+        uint32_t distance_frac;
         bool engine;
         bool side_light;
         bool left_indicator;
         bool right_indicator;
         
+        /* Time step */
+        uint32_t step_ms;
+        int32_t step_dt;
+        bool adaptive;
+        
         /* Threads */
         Thread _thread;
 };
@@ -12,484 +12,589 @@
 /* Pinout includes */
 #include "pinout.h"
 
+/* Mbed includes */
+#include "us_ticker_api.h"
+
 /*  LCD Initialization */
 //  @brief  Initialize LCD and prints layout
-//
-//  N.B.: Uses semaphore
 void Controller::LCDInit()
 {
-    // Wait for the LCD semaphore
-    LCDs.wait();
     // Initialise 16-bit I/O chip
     par_port = new MCP23017(p9, p10, 0x40); 
     
     // Initialise 2x26 char display
     lcd = new WattBob_TextLCD(par_port); 
     
+    // Wait on the busy flag rather than fixed delays
+    lcd->setBusyPolling(true);
+    
     // Turn LCD backlight ON
     par_port->write_bit(1,BL_BIT); 
     
     // Clear display
     lcd->cls();
     
-    // Display Initial Layout
-    lcd->locate(0,0);
-    lcd->printf("    mph");
-    lcd->locate(1,7);
-    lcd->printf(" m");
+    // From here on the renderer thread owns the display, see driveOdo
+    display = new LCDQueue(lcd, osPriorityLow, LCD_STACK);
+    display->setProfiler(&profiler);
     
-    //Relese the LCD semaphore
-    LCDs.release();
+    // Display Initial Layout
+    display->write(0, 0, "    mph", 7);
+    display->write(1, 7, " m", 2);
 }
 
 /*  Serial Initialization */
-//  @brief  Initialize Serial and prints headers
+//  @brief  Initialize Serial
 //
-//  N.B.: Uses semaphore
+//  N.B.: the link carries binary frames (see telemetry.h), and the
+//        profiler dump as text when asked for, see pollConsole
 void Controller::SerialInit()
 {   
-    Serials.wait();
-     
     // Set Baud Rate
     serial.baud(115200);
-    
-    // Print heading for CSV
-    serial.printf("speed, acceleretor, brake\r\n");
-    
-    Serials.release();
-
 }
 
 /*  Flashes an indicator */
-//  @brief  Flashes a LED at 1Hz
+//  @brief  Flashes a LED at 1Hz, on for 400ms
 //
-//  N.B.: Thread Worker
+//  N.B.: Called every 100ms by flashIndicators
 void Controller::Flash1Hz()
 {
-    while (1)
+    if (flash_tick < 4)
     {
-        Thread::signal_wait(1);
         right_led = Simulator.getRight();
         left_led = Simulator.getLeft();
-        wait_ms(400);
+    }
+    else
+    {
         right_led = 0;
         left_led = 0;
-        Thread::wait(750);
     }
 }
 
 /*  Flashes two indicators */
-//  @brief  Flashes two LEDs at 2Hz
+//  @brief  Flashes two LEDs at 2Hz, on for 200ms
 //
-//  N.B.: Thread Worker
+//  N.B.: Called every 100ms by flashIndicators
 void Controller::HazardMode()
 {
-    while(1)
+    if ((flash_tick % 5) < 2)
     {
-        Thread::signal_wait(1);
         right_led = 1;
         left_led = 1;
-        wait_ms(200);
+    }
+    else
+    {
         right_led = 0;
         left_led = 0;
-        Thread::wait(400);
     }
 }
 
+/*  Uptime */
+//  @return milliseconds since reset, 49 days before it wraps
+//
+//  N.B.: the 32-bit microsecond ticker wraps every 71.6 minutes; each
+//        call adds the ticks since the previous one, so it must be
+//        called more often than that (sendSerial runs every 20s)
+uint32_t Controller::uptimeMs()
+{
+    uint32_t now = us_ticker_read();
+    uint32_t elapsed = now - clock_last_us + clock_rem_us;
+    clock_last_us = now;
+    clock_ms += elapsed / 1000;
+    clock_rem_us = elapsed % 1000;
+    return clock_ms;
+}
+
 /*  Default Constructor */
-//  @brief  Init Semaphore, Threads, Serial, LCD, Car Simulator
+//  @brief  Init Serial, LCD, Car Simulator and the task table,
+//          then starts the executive and the switch bank.
 //          Set average speed and warning led to 0
 Controller::Controller()
 :   serial(USBTX, USBRX),
-    Speeds(4),
-    Mails(1),
-    Serials(1),
-    LCDs(1),
-    updateCommandsTh(&Controller::commandsStarter, this, osPriorityNormal,1024),
-    updateEngineTh(&Controller::engineStarter, this, osPriorityNormal,1024),
-    updateSpeedTh(&Controller::speedStarter, this, osPriorityNormal,1024),
-    driveServoTh(&Controller::servoStarter, this, osPriorityNormal,1024),
-    updateWarningTh(&Controller::warningStarter, this, osPriorityNormal,1024),
-    driveOdoTh(&Controller::odoStarter, this, osPriorityNormal,1024),
-    sendMailTh(&Controller::mailStarter, this, osPriorityNormal,1024),
-    sendSerialTh(&Controller::serialStarter, this, osPriorityNormal,1024),
-    updateSidelightTh(&Controller::sideStarter, this, osPriorityNormal,1024),
-    driveIndicatorsTh(&Controller::indicatorStarter, this, osPriorityNormal,1024),
-    flashTh(&Controller::flashStarter, this, osPriorityNormal,1024),
-    hazardTh(&Controller::hazardStarter, this, osPriorityNormal,1024)
+    send_queue(RING_OVERWRITE_OLDEST),
+    flash_tick(0),
+    clock_ms(0),
+    clock_rem_us(0),
+    clock_last_us(0),
+    dump_line(-1),
+    stack_line(-1),
+    executive(osPriorityNormal, EXECUTIVE_STACK),
+    switches(osPriorityAboveNormal, 1024)
+#if PEDAL_OVERSAMPLING
+    , pedals(ACCELERATOR_PIN, BRAKE_PIN)
+#endif
 {
     speed_warning = 0;
     speed_average = 0;
     LCDInit();
     SerialInit();
+    
+    // Rate monotonic order: faster tasks run first within a frame
+    executive.addTask("commands",   &Controller::commandsStarter,  this, 100);
+    executive.addTask("flash",      &Controller::flashStarter,     this, 100);
+    executive.addTask("speed",      &Controller::speedStarter,     this, 200);
+    executive.addTask("odo",        &Controller::odoStarter,       this, 500);
+    executive.addTask("servo",      &Controller::servoStarter,     this, 1000);
+    executive.addTask("console",    &Controller::consoleStarter,   this, 1000);
+    executive.addTask("warning",    &Controller::warningStarter,   this, 2000);
+    executive.addTask("mail",       &Controller::mailStarter,      this, 5000);
+    executive.addTask("stacks",     &Controller::stacksStarter,    this, STACK_SAMPLE_MS);
+    executive.addTask("serial",     &Controller::serialStarter,    this, 20000);
+    executive.setProfiler(&profiler);
+    executive.start();
+    
+    // Switches only wake their thread when they move
+    switches.addSwitch(&engine_sw,    &Controller::engineStarter,    this);
+    switches.addSwitch(&sidelight_sw, &Controller::sideStarter,      this);
+    switches.addSwitch(&left_sw,      &Controller::indicatorStarter, this);
+    switches.addSwitch(&right_sw,     &Controller::indicatorStarter, this);
+    switches.setProfiler(&profiler);
+    switches.start();
+    
+    // Every thread fills its stack when created, the marks are read
+    // from here on
+    stacks.add("car",       Simulator.getThread());
+    stacks.add("executive", executive.getThread());
+    stacks.add("lcd",       display->getThread());
+    stacks.add("switches",  switches.getThread());
+    stacks.addSystem();
+}
+
+/*  Standard Accessor */
+Car &Controller::getCar()
+{
+    return Simulator;
+}
+
+/*  Standard Accessor */
+Executive &Controller::getExecutive()
+{
+    return executive;
+}
+
+/*  Standard Accessor */
+TelemetryRing<message, TELEMETRY_SIZE> &Controller::getTelemetry()
+{
+    return send_queue;
 }
 
-/*  Updates speed history */
-//  @brief  pushes a raw valued of speed in the history queue
-void Controller::updateHistory()
+/*  Standard Accessor */
+AsyncSerial &Controller::getSerial()
 {
-    char speed = Simulator.getSpeed();
-    speed_history.push(speed);
+    return serial;
 }
 
+/*  Standard Accessor */
+WattBob_TextLCD *Controller::getLCD()
+{
+    return lcd;
+}
+
+/*  Standard Accessor */
+//  @return LCD command queue, for its depth and latency
+LCDQueue *Controller::getDisplay()
+{
+    return display;
+}
+
+/*  Standard Accessor */
+//  @return I/O expander, for its I2C counters
+MCP23017 *Controller::getPort()
+{
+    return par_port;
+}
+
+/*  Standard Accessor */
+SwitchBank &Controller::getSwitches()
+{
+    return switches;
+}
+
+/*  Standard Accessor */
+//  @return execution time and jitter of every instrumented task
+Profiler &Controller::getProfiler()
+{
+    return profiler;
+}
+
+/*  Standard Accessor */
+//  @return deepest stack use of every thread
+StackMonitor &Controller::getStacks()
+{
+    return stacks;
+}
+
+#if PEDAL_OVERSAMPLING
+/*  Standard Accessor */
+PedalSampler &Controller::getPedals()
+{
+    return pedals;
+}
+#endif
+
 /*  Updates acceleration  */
 //  @pram   pin     analog pin
 //  @brief  reads acceleration value from analog pin
-void Controller::updateAcceleration(AnalogIn pin)
+//
+//  N.B.:   0 - 255 scaled from the 12-bit code with a multiply and a
+//          shift, no float; the same value as the former read() * 255
+//          (pedalbench.h)
+void Controller::updateAcceleration(AnalogIn &pin)
 {
-    float reading = (pin.read() * 255);
-    char acceleration = reading;
+    char acceleration = pedalScale(pin.read_u16() >> 4);
     Simulator.writeAcc(acceleration);
 }
 
 /*  Updates brake  */
 //  @pram   pin     analog pin
 //  @brief  reads brake value from analog pin
-void Controller::updateBrake(AnalogIn pin)
+//
+//  N.B.:   0 - 255 scaled from the 12-bit code with a multiply and a
+//          shift, no float; the same value as the former read() * 255
+//          (pedalbench.h)
+void Controller::updateBrake(AnalogIn &pin)
 {
-    float reading = (pin.read() * 255);
-    char brake = reading;
-    //serial.printf("B = %i", brake);
-    //serial.printf("\r\n");
+    char brake = pedalScale(pin.read_u16() >> 4);
     Simulator.writeBrake(brake);
 }
 
 /*  Calculates average */
 //  @return     average speed
-//  @brief      average 3 raw value from speed_history
+//  @brief      pushes a raw value of speed in speed_history and
+//              averages the last SPEED_WINDOW values,
 //              also updates speed_warning
 char Controller::getAverage()
 {
-    if (speed_history.size() < 4)
-        {
-            return speed_average;    
-        }
-    else
-        {
-            char one = speed_history.front();
-            speed_history.pop();
-            char two = speed_history.front();
-            speed_history.pop();
-            char three = speed_history.front();
-            speed_history.pop();
-            speed_average = (one + two + three)/3;
-            if (speed_average > 70)
-                speed_warning = 1;
-            else
-                speed_warning = 0;
-            return speed_average;
-        }
+    char average = speed_history.update(Simulator.getSpeed());
+    speed_warning = average > 70;
+    return average;
 }
 
 /*  Updates Indicators */
 //  @brief  updates Indicators valued reading from digital inputs
-void Controller::updateIndicators(DigitalIn left, DigitalIn right)
+void Controller::updateIndicators(int left, int right)
 {
     Simulator.writeLeft(left);
     Simulator.writeRight(right);
 }
 
 /*  Flashes Indicators */
-//  @brief  Trigger threads in accords to Indicators values
+//  @brief  Drives the LED pattern in accords to Indicators values
+//  @rate   10Hz
+//
+//  N.B.:   Executive step
 void Controller::flashIndicators()
 {
-
     if(Simulator.getLeft() && Simulator.getRight())
-        hazardTh.signal_set(1);
+        HazardMode();
     else if (Simulator.getLeft())
-        flashTh.signal_set(1);
+        Flash1Hz();
     else if (Simulator.getRight())
-        flashTh.signal_set(1);
+        Flash1Hz();
     else
         {
             left_led = 0;
             right_led = 0;
         }
+    if (++flash_tick == 10)
+        flash_tick = 0;
 }
 /*  Updates Commands */
 //  @brief  updates acceleration, brake
 //  @rate   10Hz
 //
 //  N.B.:   Uses semaphore
-//  N.B.:   Thread worker
+//  N.B.:   With PEDAL_OVERSAMPLING the values are the latest filtered
+//          ones, no conversion is started here
+//  N.B.:   Executive step
 void Controller::updateCommands()
 {
-    while(1)
-    {
-        Simulator.Pedals.wait();
-        updateAcceleration(accelerator_pedal);
-        updateBrake(brake_pedal);
-        Simulator.Pedals.release();
-        Thread::wait(100);
-    }
+    Simulator.Pedals.wait();
+#if PEDAL_OVERSAMPLING
+    Simulator.writeAcc(pedals.getAccelerator());
+    Simulator.writeBrake(pedals.getBrake());
+#else
+    updateAcceleration(accelerator_pedal);
+    updateBrake(brake_pedal);
+#endif
+    Simulator.Pedals.release();
 }
 
 /*  Updates Engine */
 //  @brief  updates engine value and turn the car simulator
 //          on or off accordingly
-//  @rate   2Hz
 //
-//  N.B.:   Thread worker
+//  N.B.:   Switch handler, engine_sw changed
 void Controller::updateEngine()
 {
-    while(1)
+    if (engine_sw)
     {
-        if (engine_sw)
-        {
-            Simulator.TurnOn();
-            engine_led = 1;
-        }
-        else
-        {
-            Simulator.TurnOff();
-            engine_led = 0;
-        }
-        Thread::wait(500);
+        Simulator.TurnOn();
+        engine_led = 1;
+    }
+    else
+    {
+        Simulator.TurnOff();
+        engine_led = 0;
     }
 }
 
 /*  Updates Speed */
-//  @brief  updates speed history queue, calculates average
+//  @brief  updates speed history, calculates average
 //  @rate   5Hz
 //
-//  N.B.:   Uses semaphore
-//  N.B.:   Thread worker
+//  N.B.:   Executive step
 void Controller::updateSpeed()
 {
-    while(1)
-    {
-        Speeds.wait();
-        updateHistory();
-        speed_average = getAverage();
-        Speeds.release();
-        Thread::wait(200);
-    }
+    speed_average = getAverage();
 }
 
 /*  Drive Servo */
 //  @brief  updates servo position in accords to average speed
 //  @rate   1Hz
 //
-//  N.B.:   Thread worker
+//  N.B.:   Executive step
 void Controller::driveServo()
 {
-    while(1)
-    {
-        float position = speed_average / 255.0;
-        motor = position;
-        Thread::wait(1000);
-    }
+    float position = speed_average / 255.0;
+    motor = position;
 }
 
 /*  Updates Warning */
 //  @brief  updates warning LED for exceeding speed limit
 //  @rate   0.5Hz
 //
-//  N.B.:   Thread worker
+//  N.B.:   Executive step
 void Controller::updateWarning()
 {
-    while(1)
-    {
-        warning = speed_warning;
-        Thread::wait(2000);
-    }
+    warning = speed_warning;
 }
 
 /*  Drive Odometer */
 //  @brief  write distance and average speed on the LCD Odometer
 //  @rate   2Hz
 //
-//  N.B.:   Uses semaphore
-//  N.B.:   Thread worker
+//  N.B.:   The distance wraps at ODO_WRAP metres, as 6 digits
+//  N.B.:   Only posts to the LCD queue, the renderer does the I2C work
+//          and only the characters that changed reach the display
+//  N.B.:   Executive step
 void Controller::driveOdo()
 {
-    while(1)
-    {
-        Speeds.wait();
-        int distance = Simulator.getDistance();
-        char speed = speed_average;
-        Speeds.release();
-        LCDs.wait();
-        lcd->locate(1,0);
-        lcd->printf("%06i",distance);
-        lcd->locate(0,0);
-        lcd->printf("%03i",speed);
-        if(Simulator.IsItOn())
-        {
-            lcd->locate(0,13);
-            lcd->printf("   ");
-        }
-        else
-        {
-            lcd->locate(0,13);
-            lcd->printf("(P)");
-        }
-        LCDs.release();
-        Thread::wait(500);
-        
-    }
+    char text[FixedField<6>::SIZE];
+    uint32_t distance = (uint32_t)Simulator.getDistance() % ODO_WRAP;
+    char speed = speed_average;
+    display->write(1, 0, text, FixedField<6>::format(text, distance));
+    display->write(0, 0, text, FixedField<3>::format(text, speed));
+    if(Simulator.IsItOn())
+        display->write(0, 13, "   ", 3);
+    else
+        display->write(0, 13, "(P)", 3);
 }
 
 /*  Updates the send_queue */
-//  @brief  push a new 'message' in the send_queue 
+//  @brief  push a new 'message' in the send_queue, overwriting
+//          the oldest one if sendSerial fell behind
 //  @rate   0.2Hz
 //
-//  N.B.:   Uses semaphore
-//  N.B.:   Thread worker
+//  N.B.:   Never blocks on the serial port
+//  N.B.:   Executive step
 void Controller::sendMail()
 {
-    while(1)
-    {
-        Mails.wait();
-        message *mail = send_queue.alloc();
-        Speeds.wait();
-        mail->speed = speed_average;
-        Speeds.release();
-        mail->accelerator = Simulator.getAcc();
-        mail->brake = Simulator.getBrake();
-        send_queue.put(mail);
-        Mails.release();
-        Thread::wait(5000);
-        
-    }
+    message mail;
+    mail.speed = speed_average;
+    mail.accelerator = Simulator.getAcc();
+    mail.brake = Simulator.getBrake();
+    mail.time = uptimeMs();
+    send_queue.put(mail);
 }
 
 /*  Send a Message over serial */
-//  @brief  pop the send_queue and send a 'message' over serial
+//  @brief  pop the send_queue and send every pending 'message'
+//          over serial, batched in telemetry frames of up to
+//          TELEMETRY_MAX_RECORDS records
 //  @rate   0.05Hz
 //
-//  N.B.:   Uses semaphore
-//  N.B.:   Thread worker
+//  N.B.:   Frames are queued for the TX interrupt; messages stay in
+//          the send_queue while a whole frame would not fit
+//  N.B.:   Executive step
 void Controller::sendSerial()
 {
-    while(1)
+    message mail;
+    while (serial.space() >= TELEMETRY_MAX_FRAME && send_queue.get(mail))
     {
-        Mails.wait();
-        osEvent evt = send_queue.get();
-        if (evt.status == osEventMail) 
-        {
-            message *mail = (message*)evt.value.p;
-            serial.printf("%03i,", mail->speed);
-            serial.printf("%03i,", (mail->accelerator));
-            serial.printf("%03i", (mail->brake));
-            serial.printf("\r\n");
-            send_queue.free(mail);
-        }
-        Thread::wait(15000);
-        Mails.release();
+        telemetry.begin(uptimeMs());
+        telemetry.add(mail);
+        while (!telemetry.full() && send_queue.get(mail))
+            telemetry.add(mail);
+
+        uint32_t length = telemetry.finish();
+        serial.write(telemetry.data(), length);
     }
 }
 
 /*  Updates Sidelight */
 //  @brief  updates sidelight and flashes an LED accordingly 
-//  @rate   1Hz
 //
-//  N.B.:   Thread worker
+//  N.B.:   Switch handler, sidelight_sw changed
 void Controller::updateSidelight()
 {
-    while(1)
-    {
-        Simulator.writeSide(sidelight_sw);
-        sidelight_led = Simulator.getSide();
-        Thread::wait(1000);
-    } 
+    Simulator.writeSide(sidelight_sw);
+    sidelight_led = Simulator.getSide();
 }
 
 /*  Drive Indicators */
 //  @brief  updates indicators and flashes an LEDs accordingly 
-//  @rate   0.5Hz
 //
-//  N.B.:   Thread worker
+//  N.B.:   Switch handler, left_sw or right_sw changed
 void Controller::driveIndicators()
 {
-    while(1)
+    updateIndicators(left_sw.read(), right_sw.read());
+}
+
+/*  Samples the stacks */
+//  @brief  reads the stack mark of every thread, so the table records
+//          when each one last moved
+//  @rate   0.2Hz
+//
+//  N.B.:   Executive step
+void Controller::sampleStacks()
+{
+    stacks.sample();
+}
+
+/*  Polls the console */
+//  @brief  'P' starts a dump of the profiler table, one text line per
+//          task, 'R' clears the statistics, 'S' starts a dump of the
+//          stack table, one text line per thread
+//  @rate   1Hz
+//
+//  N.B.:   Lines are queued only while a whole one fits, a long table
+//          goes out over several ticks; sendSerial keeps its frames
+//  N.B.:   Text shares the line with telemetry frames, which receivers
+//          find again by their sync byte
+//  N.B.:   Executive step
+void Controller::pollConsole()
+{
+    while (serial.readable())
+    {
+        int c = serial.getc();
+        if (c == 'P' && dump_line < 0)
+            dump_line = 0;
+        else if (c == 'R')
+            profiler.reset();
+        else if (c == 'S' && stack_line < 0)
+            stack_line = 0;
+    }
+
+    char line[PROFILER_LINE];
+    while (dump_line >= 0 && serial.space() >= PROFILER_LINE)
+    {
+        if (dump_line == 0)
+            serial.write(line, profiler.header(line));
+        else
+            serial.write(line, profiler.format(dump_line - 1, line));
+        if (++dump_line > profiler.getCount())
+            dump_line = -1;
+    }
+    while (dump_line < 0 && stack_line >= 0 && serial.space() >= STACK_LINE)
     {
-        updateIndicators(left_sw, right_sw);
-        flashIndicators();
-        Thread::wait(2000);
+        if (stack_line == 0)
+            serial.write(line, stacks.header(line));
+        else
+            serial.write(line, stacks.format(stack_line - 1, line));
+        if (++stack_line > stacks.getCount())
+            stack_line = -1;
     }
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::commandsStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->updateCommands();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to switch handler */
 void Controller::engineStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->updateEngine();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::speedStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->updateSpeed();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::servoStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->driveServo();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::warningStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->updateWarning();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::odoStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->driveOdo();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::mailStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->sendMail();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::serialStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->sendSerial();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to switch handler */
 void Controller::sideStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->updateSidelight();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to switch handler */
 void Controller::indicatorStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
     instance->driveIndicators();
 }
 
-/* Static callback to Thread worker */
+/* Static callback to executive step */
 void Controller::flashStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
-    instance->Flash1Hz();
+    instance->flashIndicators();
+}
+
+/* Static callback to executive step */
+void Controller::consoleStarter(void const *p)
+{
+    Controller *instance = (Controller*)p;
+    instance->pollConsole();
 }
 
-/* Static callback to Thread worker */
-void Controller::hazardStarter(void const *p)
+/* Static callback to executive step */
+void Controller::stacksStarter(void const *p)
 {
     Controller *instance = (Controller*)p;
-    instance->HazardMode();
+    instance->sampleStacks();
 }
\ No newline at end of file
@@ -2,11 +2,13 @@
 //
 //  controller.h
 //
-//  Requirements: rtos.h, mbed.h, message.h, car.h, Servo.h, MCP23017.h,
-//                WattBob_TextLCD.h
+//  Requirements: rtos.h, mbed.h, message.h, car.h, executive.h, average.h,
+//                ring.h, telemetry.h, asyncserial.h, format.h, lcdqueue.h,
+//                switches.h, pedals.h, profiler.h, stackmonitor.h, Servo.h,
+//                MCP23017.h, WattBob_TextLCD.h
 //
 //  Hardware Requirements:
-//          -Serial USB port
+//          -Serial USB port (interrupt driven)
 //          -WattBob LCD
 //
 //  Defines a Controller Class that controls a Car Object
@@ -14,42 +16,61 @@
 //
 //  Class members:
 //          -Simulator      (Car)
-//          -speed_history  (queue<uint8_t>)
+//          -speed_history  (MovingAverage<SPEED_WINDOW>)
 //          -speed_average  (uint8_t)
 //          -speed_warning  (bool)
-//          -send_queue     (message)*
+//          -send_queue     (TelemetryRing<message>)*
+//          -telemetry      (TelemetryEncoder)
+//          -display        (LCDQueue, renders on its own low priority thread)
+//          -switches       (SwitchBank, engine/sidelight/indicator inputs)
+//          -pedals         (PedalSampler, if PEDAL_OVERSAMPLING)
+//          -profiler       (Profiler, execution time and jitter per task)
+//          -stacks         (StackMonitor, deepest stack use per thread)
 //
 //  Methods:  
 //          -This class provides standard accessors to every member of the class
 //          -updateCommands         updates acceleration and brake
 //          -updateEngine           updates engine status
-//          -updateSpeed            updates speed by avaraging
+//          -updateSpeed            updates speed by a moving average
 //          -driveServo             updates servo position in accords to speed
 //          -updateWarning          updates a warning if speed goes over 70mph         
 //          -driveOdo               updates Odometer
-//          -sendMail               build a 'message' and pushes into a Mail queue
-//          -sendSerial             send a 'message' over serial 
+//          -sendMail               build a 'message' and pushes into the ring
+//          -sendSerial             send pending 'messages' over serial in
+//                                  binary frames (see telemetry.h)
 //          -updateSidelight        updates sidelight
 //          -driveIndicators        updates indicators
+//          -sampleStacks           samples the stack marks of every thread
+//          -pollConsole            serial commands: 'P' dumps the profiler
+//                                  table as text, 'R' clears it, 'S' dumps
+//                                  the stack table
 //
-//  Threads: 
-//          -updateCommandsTh       calls 'updateCommands'  rate = 10Hz
-//          -updateEngineTh         calls 'updateEngine'    rate = 2Hz
-//          -updateSpeedTh          calls 'updateSpeed'     rate = 5Hz
-//          -driveServoTh           calls 'driveServo'      rate = 1Hz
-//          -updateWarningTh        calls 'updateWarning'   rate = 0.5Hz
-//          -driveOdoTh             calls 'driveOdo'        rate = 2Hz
-//          -sendMailTh             calls 'sendMail'        rate = 0.2Hz
-//          -sendSerialTh           calls 'sendSerial'      rate = 0.05Hz
-//          -updateSidelightTh      calls 'updateSidelight' rate = 1Hz
-//          -driveIndicatorsTh      calls 'driveIndicators' rate = 0.5Hz
-//          -flashTh                Flashes a LED in accords to indicators
-//                                                          rate = 1Hz
-//          -hazardTh               Flashed two LEDs in accords to indicatos
-//                                                          rate = 2Hz
+//  Schedule:
+//          All workers are non-blocking steps run by a single cyclic
+//          executive thread (see executive.h); minor frame 100ms,
+//          major frame 20s.
+//          -updateCommands         rate = 10Hz
+//          -flashIndicators        rate = 10Hz (drives the 1Hz flash and
+//                                               the 2Hz hazard pattern)
+//          -updateSpeed            rate = 5Hz
+//          -driveOdo               rate = 2Hz
+//          -driveServo             rate = 1Hz
+//          -pollConsole            rate = 1Hz
+//          -updateWarning          rate = 0.5Hz
+//          -sendMail               rate = 0.2Hz
+//          -sampleStacks           rate = 0.2Hz
+//          -sendSerial             rate = 0.05Hz
 //
+//  Events:
+//          Run by the switch bank thread (see switches.h) once a switch
+//          has settled on a new level, SWITCH_DEBOUNCE_MS after its
+//          last edge.
+//          -updateEngine           engine_sw
+//          -updateSidelight        sidelight_sw
+//          -driveIndicators        left_sw, right_sw
 //
-//  * Mail queue
+//
+//  * Wait-free ring, oldest messages are overwritten when full
 //
 //************************************************************************
 #ifndef __CONTROLLER_H__
@@ -58,6 +79,17 @@
 /* Inheritance includes */
 #include "car.h"
 #include "message.h"
+#include "executive.h"
+#include "average.h"
+#include "ring.h"
+#include "telemetry.h"
+#include "asyncserial.h"
+#include "format.h"
+#include "lcdqueue.h"
+#include "switches.h"
+#include "pedals.h"
+#include "profiler.h"
+#include "stackmonitor.h"
 
 /* Mbed & RTOS includes */
 #include "mbed.h"
@@ -68,10 +100,21 @@
 #include "WattBob_TextLCD.h"
 #include "Servo.h"
 
-/* Standard includes */
-#include <queue>
+/* Samples averaged by updateSpeed, 0.6s at 5Hz */
+#define SPEED_WINDOW    3
+
+/* The odometer shows 6 digits and wraps past them, like a mechanical
+   one, so the " m" label after them is never overwritten */
+#define ODO_WRAP        1000000
+
+/* Messages buffered between sendMail and sendSerial */
+#define TELEMETRY_SIZE  128
 
-using namespace std;
+/* Stacks of the executive and LCD renderer threads, in bytes: the
+   recommended sizes of the stack table (see StackMonitor), rounded up
+   to 512 */
+#define EXECUTIVE_STACK 1024
+#define LCD_STACK       1536
 
 class Controller
 {
@@ -79,7 +122,7 @@ class Controller
         /* Default Constructor */
         Controller();
         
-        /* Static callbacks to Threads */
+        /* Static callbacks to executive steps and switch handlers */
         static void commandsStarter(void const *p);
         static void engineStarter(void const *p);
         static void speedStarter(void const *p);
@@ -91,9 +134,10 @@ class Controller
         static void sideStarter(void const *p);
         static void indicatorStarter(void const *p);
         static void flashStarter(void const *p);
-        static void hazardStarter(void const *p);
+        static void consoleStarter(void const *p);
+        static void stacksStarter(void const *p);
         
-        /* Threads workers */        
+        /* Executive steps and switch handlers */
         void updateCommands();
         void updateEngine();
         void updateSpeed();
@@ -104,53 +148,79 @@ class Controller
         void sendSerial();
         void updateSidelight();
         void driveIndicators();
+        void flashIndicators();
+        void pollConsole();
+        void sampleStacks();
+        
+        /* Schedule and telemetry statistics */
+        Car &getCar();
+        Executive &getExecutive();
+        TelemetryRing<message, TELEMETRY_SIZE> &getTelemetry();
+        AsyncSerial &getSerial();
+        WattBob_TextLCD *getLCD();
+        LCDQueue *getDisplay();
+        MCP23017 *getPort();
+        SwitchBank &getSwitches();
+        Profiler &getProfiler();
+        StackMonitor &getStacks();
+#if PEDAL_OVERSAMPLING
+        PedalSampler &getPedals();
+#endif
         
     private:
-        void updateHistory();
-        void updateAcceleration(AnalogIn pin);
-        void updateBrake(AnalogIn pin);
-        void updateIndicators(DigitalIn left, DigitalIn right);
+        void updateAcceleration(AnalogIn &pin);
+        void updateBrake(AnalogIn &pin);
+        void updateIndicators(int left, int right);
         char getAverage();
-        void flashIndicators();
         
         /* Hardware Init */
         void LCDInit();
         void SerialInit();
         
-        /* Indicators threads workers */
+        /* Indicators patterns */
         void Flash1Hz();
         void HazardMode();
+        
+        /* Frame timestamps */
+        uint32_t uptimeMs();
     
     protected:
         /* Members */
         Car Simulator;
-        queue<char> speed_history;
+        MovingAverage<SPEED_WINDOW> speed_history;
         char speed_average;
         bool speed_warning;
         WattBob_TextLCD *lcd;
+        LCDQueue *display;
         MCP23017 *par_port;
-        Serial serial;
-        Mail<message, 100> send_queue;
+        AsyncSerial serial;
+        TelemetryRing<message, TELEMETRY_SIZE> send_queue;
+        TelemetryEncoder telemetry;
+        char flash_tick;
+        
+        /* Millisecond clock, extended across ticker wraps by uptimeMs */
+        uint32_t clock_ms;
+        uint32_t clock_rem_us;
+        uint32_t clock_last_us;
+        
+        /* Task timings, dumped by pollConsole */
+        Profiler profiler;
+        int dump_line;
+        
+        /* Stack usage, dumped by pollConsole */
+        StackMonitor stacks;
+        int stack_line;
+        
+        /* Cyclic executive */
+        Executive executive;
         
-        /*Semaphores */
-        Semaphore Speeds;
-        Semaphore Mails;
-        Semaphore Serials;
-        Semaphore LCDs;
+        /* Switch inputs */
+        SwitchBank switches;
         
-        /* Threads */
-        Thread updateCommandsTh;
-        Thread updateEngineTh;
-        Thread updateSpeedTh;
-        Thread driveServoTh;
-        Thread updateWarningTh;
-        Thread driveOdoTh;
-        Thread sendMailTh;
-        Thread sendSerialTh;
-        Thread updateSidelightTh;
-        Thread driveIndicatorsTh;
-        Thread flashTh;
-        Thread hazardTh;
+#if PEDAL_OVERSAMPLING
+        /* Oversampled pedals */
+        PedalSampler pedals;
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+//************************************************************************
+//
+//  cycles.h
+//
+//  Requirements: mbed.h
+//
+//  Cycle counter for timing short code paths.
+//
+//  On the Cortex-M3 this is the DWT CYCCNT register, one count per core
+//  clock (96MHz on the LPC1768), enabled by cyclesInit(). The host build
+//  has no such counter and stands in with std::chrono::steady_clock in
+//  nanoseconds of real time, so host figures compare two paths but are
+//  not target cycle counts.
+//
+//  Functions:
+//          -cyclesInit     enables the counter
+//          -cyclesRead     current count, wraps at 32 bits
+//
+//  Usage:
+//          uint32_t start = cyclesRead();
+//          ...
+//          uint32_t spent = cyclesRead() - start;
+//
+//************************************************************************
+#ifndef __CYCLES_H__
+#define __CYCLES_H__
+
+/* Mbed includes */
+#include "mbed.h"
+
+#if defined(TARGET_LPC1768)
+
+/* Counter unit, for reports */
+#define CYCLES_UNIT     "cycles"
+
+inline void cyclesInit()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+inline uint32_t cyclesRead()
+{
+    return DWT->CYCCNT;
+}
+
+#else
+
+#define CYCLES_UNIT     "ns"
+
+inline void cyclesInit()
+{
+}
+
+/* Host steady clock in nanoseconds, defined by the simulator */
+uint32_t cyclesRead();
+
+#endif
+
+#endif
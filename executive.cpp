@@ -0,0 +1,234 @@
+//************************************************************************
+//
+//  executive.cpp
+//
+//  Executive Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "executive.h"
+
+/* Mbed includes */
+#include "us_ticker_api.h"
+
+/* Signal starting the schedule */
+#define EXECUTIVE_START     0x1
+
+/*  Default Constructor */
+//  @param  priority    priority of the executive thread
+//  @param  stack_size  stack of the executive thread, shared by all steps
+//
+//  @brief  Creates the thread, which waits for start()
+Executive::Executive(osPriority priority, uint32_t stack_size)
+: count(0),
+  minor_ms(0),
+  major_frames(0),
+  last_tick(0),
+  elapsed_us(0),
+  busy_us(0),
+  profiler(NULL),
+  _thread(&Executive::threadStarter, this, priority, stack_size)
+{
+}
+
+/*  Adds a task to the table */
+//  @param  name        task name used in reports
+//  @param  step        non-blocking step function
+//  @param  arg         argument passed to step
+//  @param  period_ms   release period in milliseconds
+//  @return false if the table is full or the schedule already started
+//
+//  N.B.: tasks released in the same frame run in table order
+bool Executive::addTask(const char *name, void (*step)(void const *p), void *arg,
+                        uint32_t period_ms)
+{
+    if (count == EXECUTIVE_MAX_TASKS || major_frames != 0 || period_ms == 0)
+        return false;
+
+    table[count].step = step;
+    table[count].arg = arg;
+    table[count].period = period_ms;
+    table[count].profile = -1;
+
+    stats[count].name = name;
+    stats[count].period_ms = period_ms;
+    stats[count].runs = 0;
+    stats[count].max_jitter = 0;
+    stats[count].total_jitter = 0;
+    stats[count].max_exec = 0;
+    stats[count].total_exec = 0;
+
+    count++;
+    return true;
+}
+
+/*  Starts the schedule */
+//  @brief  minor frame = gcd of the periods, major frame = lcm,
+//          periods are converted to minor frames
+void Executive::start()
+{
+    if (count == 0 || major_frames != 0)
+        return;
+
+    if (profiler)
+        for (int i = 0; i < count; i++)
+            table[i].profile = profiler->add(stats[i].name, table[i].period * 1000);
+
+    minor_ms = table[0].period;
+    for (int i = 1; i < count; i++)
+        minor_ms = gcd(minor_ms, table[i].period);
+
+    major_frames = 1;
+    for (int i = 0; i < count; i++)
+    {
+        table[i].period /= minor_ms;
+        major_frames = major_frames / gcd(major_frames, table[i].period)
+                       * table[i].period;
+    }
+
+    _thread.signal_set(EXECUTIVE_START);
+}
+
+/*  Attaches a Profiler */
+//  @param  profiler    table that gets one entry per task at start()
+//
+//  N.B.: must be called before start()
+void Executive::setProfiler(Profiler *profiler)
+{
+    if (major_frames == 0)
+        this->profiler = profiler;
+}
+
+/*  Thread worker */
+//  @rate   1 / minor frame
+//  @brief  runs the tasks released in the current frame, then sleeps
+//          until the next release on the thread's periodic grid
+//
+//  N.B.:   steps must not use timed waits, they would move the grid
+//          (see Thread::period_set)
+void Executive::run()
+{
+    Thread::signal_wait(EXECUTIVE_START);
+
+    uint32_t frame = 0;
+    uint32_t release = us_ticker_read();
+    last_tick = release;
+    _thread.period_set(minor_ms);
+
+    while(1)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (frame % table[i].period)
+                continue;
+            uint32_t begin = us_ticker_read();
+            if (profiler)
+            {
+                profiler->begin(table[i].profile);
+                table[i].step(table[i].arg);
+                profiler->end(table[i].profile);
+            }
+            else
+                table[i].step(table[i].arg);
+            uint32_t end = us_ticker_read();
+            record(i, begin - release, end - begin);
+        }
+
+        if (++frame == major_frames)
+            frame = 0;
+        release += minor_ms * 1000;
+
+        uint32_t now = us_ticker_read();
+        elapsed_us += now - last_tick;
+        last_tick = now;
+
+        // A late frame keeps the release grid and catches up
+        _thread.period_wait();
+    }
+}
+
+/*  Updates the statistics of a task */
+//  @param  jitter  release to start latency in us
+//  @param  exec    execution time in us
+void Executive::record(int task, uint32_t jitter, uint32_t exec)
+{
+    TaskStats &s = stats[task];
+    s.runs++;
+    s.total_jitter += jitter;
+    if (jitter > s.max_jitter)
+        s.max_jitter = jitter;
+    s.total_exec += exec;
+    if (exec > s.max_exec)
+        s.max_exec = exec;
+    busy_us += exec;
+}
+
+/*  Standard Accessor */
+int Executive::getTaskCount()
+{
+    return count;
+}
+
+/*  Standard Accessor */
+const TaskStats &Executive::taskStats(int task)
+{
+    return stats[task];
+}
+
+/*  Standard Accessor */
+//  @return minor frame in ms, 0 before start()
+uint32_t Executive::getMinorFrame()
+{
+    return minor_ms;
+}
+
+/*  Standard Accessor */
+//  @return major frame in ms, 0 before start()
+uint32_t Executive::getMajorFrame()
+{
+    return minor_ms * major_frames;
+}
+
+/*  Standard Accessor */
+//  @return frames that ended after the next release was due
+uint32_t Executive::getOverruns()
+{
+    return _thread.overruns();
+}
+
+/*  CPU usage */
+//  @return fraction of the elapsed time spent inside step functions
+float Executive::cpuUsage()
+{
+    if (elapsed_us == 0)
+        return 0.0f;
+    return (float)busy_us / (float)elapsed_us;
+}
+
+/*  Standard Accessor */
+//  @return executive thread, for its stack usage
+Thread &Executive::getThread()
+{
+    return _thread;
+}
+
+/*  Greatest common divisor */
+uint32_t Executive::gcd(uint32_t a, uint32_t b)
+{
+    while (b)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*  Thread static callback */
+//  @brief      Calls run method
+void Executive::threadStarter(void const *p)
+{
+    Executive *instance = (Executive*)p;
+    instance->run();
+}
@@ -0,0 +1,112 @@
+//************************************************************************
+//
+//  executive.h
+//
+//  Requirements: rtos.h, mbed.h, profiler.h
+//
+//  Defines an Executive Class: a table-driven cyclic executive that runs
+//  periodic, non-blocking step functions from a single thread.
+//
+//  Every task is released at multiples of its period. The minor frame
+//  is the greatest common divisor of all periods and the major frame
+//  their least common multiple; the thread wakes once per minor frame
+//  and runs, in table order, every task whose period divides the
+//  current frame. Releases come from the RTOS periodic wait
+//  (Thread::period_wait) so execution time does not accumulate into the
+//  period, and a late frame is counted as an overrun.
+//
+//  Methods:
+//          -addTask        registers a step function and its period
+//          -start          computes the frames and starts releasing
+//          -taskStats      per-task release jitter and execution time
+//          -cpuUsage       fraction of time spent running steps
+//          -setProfiler    also records every step in a Profiler table
+//
+//  Threads:
+//          -_thread        runs the schedule, one wake-up per minor frame
+//
+//************************************************************************
+#ifndef __EXECUTIVE_H__
+#define __EXECUTIVE_H__
+
+/* Mbed & RTOS includes */
+#include "mbed.h"
+#include "rtos.h"
+
+/* Profiler includes */
+#include "profiler.h"
+
+/* Maximum number of tasks in the table */
+#define EXECUTIVE_MAX_TASKS     16
+
+/* Per task statistics, in microseconds */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    uint32_t runs;
+    uint32_t max_jitter;
+    uint64_t total_jitter;
+    uint32_t max_exec;
+    uint64_t total_exec;
+} TaskStats;
+
+class Executive
+{
+    public:
+        /* Default Constructor */
+        Executive(osPriority priority = osPriorityNormal, uint32_t stack_size = 2048);
+
+        /* Static Callback to thread */
+        static void threadStarter(void const *p);
+
+        /* Table setup */
+        bool addTask(const char *name, void (*step)(void const *p), void *arg,
+                     uint32_t period_ms);
+        void start();
+        void setProfiler(Profiler *profiler);
+
+        /* Statistics */
+        int getTaskCount();
+        const TaskStats &taskStats(int task);
+        uint32_t getMinorFrame();
+        uint32_t getMajorFrame();
+        uint32_t getOverruns();
+        float cpuUsage();
+        Thread &getThread();
+
+    private:
+        /* Thread worker */
+        void run();
+        void record(int task, uint32_t jitter, uint32_t exec);
+
+        static uint32_t gcd(uint32_t a, uint32_t b);
+
+    protected:
+        /* Task table */
+        struct Slot {
+            void (*step)(void const *p);
+            void *arg;
+            uint32_t period;        // in minor frames
+            int profile;            // Profiler entry, -1 if none
+        };
+        Slot table[EXECUTIVE_MAX_TASKS];
+        TaskStats stats[EXECUTIVE_MAX_TASKS];
+        int count;
+
+        /* Frames */
+        uint32_t minor_ms;
+        uint32_t major_frames;
+
+        /* CPU usage */
+        uint32_t last_tick;
+        uint64_t elapsed_us;
+        uint64_t busy_us;
+
+        /* Cycle accurate statistics */
+        Profiler *profiler;
+
+        /* Threads */
+        Thread _thread;
+};
+
+#endif
@@ -0,0 +1,223 @@
+//************************************************************************
+//
+//  fleet.cpp
+//
+//  CarFleet Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "fleet.h"
+
+/* Standard includes */
+#include <string.h>
+
+/*  Constructor */
+//  @param  vehicles    number of vehicles in the fleet
+//
+//  @brief  Allocates the arrays and puts every vehicle in Off Mode
+CarFleet::CarFleet(uint32_t vehicles)
+: count(vehicles)
+{
+    accelerator = new unsigned char[count];
+    brake = new unsigned char[count];
+    flags = new unsigned char[count];
+    speed = new int32_t[count];
+    distance = new uint32_t[count];
+    distance_frac = new uint32_t[count];
+
+    memset(accelerator, 0, count * sizeof(*accelerator));
+    memset(brake, 0, count * sizeof(*brake));
+    memset(flags, 0, count * sizeof(*flags));
+    memset(speed, 0, count * sizeof(*speed));
+    memset(distance, 0, count * sizeof(*distance));
+    memset(distance_frac, 0, count * sizeof(*distance_frac));
+}
+
+/*  Destructor */
+CarFleet::~CarFleet()
+{
+    delete[] accelerator;
+    delete[] brake;
+    delete[] flags;
+    delete[] speed;
+    delete[] distance;
+    delete[] distance_frac;
+}
+
+/*  Standard Accessor */
+uint32_t CarFleet::size()
+{
+    return count;
+}
+
+/*  Standard Accessor */
+char CarFleet::getAcc(uint32_t car)
+{
+    return accelerator[car];
+}
+
+/*  Standard Accessor */
+//  @param      Acc     New acceleration value
+//
+//  @brief      updates acceleration in accords to
+//              car status
+void CarFleet::writeAcc(uint32_t car, char Acc)
+{
+    accelerator[car] = (flags[car] & FLEET_ENGINE) ? Acc : 0;
+}
+
+/*  Standard Accessor */
+char CarFleet::getBrake(uint32_t car)
+{
+    return brake[car];
+}
+
+/*  Standard Accessor */
+//  @param      Brake     New brake value
+//
+//  @brief      updates brake in accords to
+//              car status
+void CarFleet::writeBrake(uint32_t car, char Brake)
+{
+    brake[car] = (flags[car] & FLEET_ENGINE) ? Brake : 0;
+}
+
+/*  Standard Accessor */
+bool CarFleet::getSide(uint32_t car)
+{
+    return flags[car] & FLEET_SIDE;
+}
+
+/*  Standard Accessor */
+//  @param  Side    sidelight value
+void CarFleet::writeSide(uint32_t car, bool Side)
+{
+    writeFlag(car, FLEET_SIDE, Side);
+}
+
+/*  Standard Accessor */
+bool CarFleet::getLeft(uint32_t car)
+{
+    return flags[car] & FLEET_LEFT;
+}
+
+/*  Standard Accessor */
+//  @param  Left    indicator value
+void CarFleet::writeLeft(uint32_t car, bool Left)
+{
+    writeFlag(car, FLEET_LEFT, Left);
+}
+
+/*  Standard Accessor */
+bool CarFleet::getRight(uint32_t car)
+{
+    return flags[car] & FLEET_RIGHT;
+}
+
+/*  Standard Accessor */
+//  @param  Right    indicator value
+void CarFleet::writeRight(uint32_t car, bool Right)
+{
+    writeFlag(car, FLEET_RIGHT, Right);
+}
+
+/*  Standard Accessor */
+int CarFleet::getDistance(uint32_t car)
+{
+    return distance[car];
+}
+
+/*  Standard Accessor */
+//  @return     integer part of the speed
+char CarFleet::getSpeed(uint32_t car)
+{
+    return speed[car] >> PHYSICS_FRAC_BITS;
+}
+
+/*  Standard Accessor */
+bool CarFleet::IsItOn(uint32_t car)
+{
+    return flags[car] & FLEET_ENGINE;
+}
+
+/*  Turn a Car On */
+//  @brief      sets the Car in ON mode
+void CarFleet::TurnOn(uint32_t car)
+{
+    flags[car] |= FLEET_ENGINE;
+}
+
+/*  Turn a Car Off */
+//  @brief      sets the Car in OFF mode, same rules as Car::TurnOff
+void CarFleet::TurnOff(uint32_t car)
+{
+    flags[car] = 0;
+    speed[car] = 0;
+    accelerator[car] = 0;
+    brake[car] = 0;
+}
+
+/*  Simulation kernel */
+//  @brief  one pass over the arrays, same rules as Car::step
+//
+//  N.B.:Branch-free body on restrict-qualified parameters so that the
+//       loop vectorizes; sub-second steps use the 32-bit distance
+//       update, which gives the same result
+static void fleetStep(uint32_t n, int32_t dt,
+                      const unsigned char * __restrict acc,
+                      const unsigned char * __restrict brk,
+                      const unsigned char * __restrict flg,
+                      int32_t * __restrict spd,
+                      uint32_t * __restrict dist,
+                      uint32_t * __restrict frac)
+{
+#if PHYSICS_FRAC_BITS <= 16
+    if (dt < PHYSICS_ONE)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t on = -(int32_t)(flg[i] & FLEET_ENGINE);
+            int32_t s = physicsSpeed(spd[i], acc[i], brk[i], dt) & on;
+            spd[i] = s;
+            physicsDistance32(dist[i], frac[i], s, dt);
+        }
+        return;
+    }
+#endif
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t on = -(int32_t)(flg[i] & FLEET_ENGINE);
+        int32_t s = physicsSpeed(spd[i], acc[i], brk[i], dt) & on;
+        spd[i] = s;
+        physicsDistance(dist[i], frac[i], s, dt);
+    }
+}
+
+/*  Simulation step */
+//  @param  dt  time step in seconds, Q format (see physics.h)
+//  @brief  same rules as Car::step for every vehicle
+void CarFleet::step(int32_t dt)
+{
+    fleetStep(count, dt, accelerator, brake, flags, speed, distance, distance_frac);
+}
+
+/*  Batch simulation */
+//  @param  ticks   number of steps
+//  @param  dt      time step in seconds, Q format
+void CarFleet::run(uint32_t ticks, int32_t dt)
+{
+    for (uint32_t t = 0; t < ticks; t++)
+        step(dt);
+}
+
+/*  Flag helper */
+//  @brief  lights only stay on while the engine is on
+void CarFleet::writeFlag(uint32_t car, unsigned char flag, bool value)
+{
+    if ((flags[car] & FLEET_ENGINE) && value)
+        flags[car] |= flag;
+    else
+        flags[car] &= ~flag;
+}
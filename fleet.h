@@ -0,0 +1,90 @@
+//************************************************************************
+//
+//  fleet.h
+//
+//  Requirements: physics.h
+//
+//  Defines a CarFleet Class that simulates many vehicles at once with
+//  the same rules as the Car Class, for fleet-level load testing.
+//
+//  State is held as a structure of arrays, one contiguous array per
+//  member, so that a tick is a single pass over each array which the
+//  compiler can vectorize.
+//
+//  Class members (one entry per vehicle):
+//          -accelerator    (uint8_t)
+//          -brake          (uint8_t)
+//          -speed          (Q16.16, see physics.h)
+//          -distance       (uint32_t + Q16.16 fraction)
+//          -flags          (engine, side light, left/right indicator)
+//
+//  Methods:
+//          -Same accessors as Car, indexed by vehicle
+//          -TurnOn/TurnOff with the Car rules
+//          -step/run advance every vehicle by a time step
+//
+//************************************************************************
+#ifndef __FLEET_H__
+#define __FLEET_H__
+
+/* Integrator includes */
+#include "physics.h"
+
+/* Flags bits */
+#define FLEET_ENGINE        0x01
+#define FLEET_SIDE          0x02
+#define FLEET_LEFT          0x04
+#define FLEET_RIGHT         0x08
+
+class CarFleet
+{
+    public:
+        /* Constructor */
+        CarFleet(uint32_t vehicles);
+        ~CarFleet();
+
+        uint32_t size();
+
+        /* Standard Accessors */
+        char getAcc(uint32_t car);
+        void writeAcc(uint32_t car, char Acc);
+        char getBrake(uint32_t car);
+        void writeBrake(uint32_t car, char Brake);
+        bool getSide(uint32_t car);
+        void writeSide(uint32_t car, bool Side);
+        bool getLeft(uint32_t car);
+        void writeLeft(uint32_t car, bool Left);
+        bool getRight(uint32_t car);
+        void writeRight(uint32_t car, bool Right);
+        int  getDistance(uint32_t car);
+        char getSpeed(uint32_t car);
+        bool IsItOn(uint32_t car);
+
+        /* Methods to update car status in accords to the engine value */
+        void TurnOn(uint32_t car);
+        void TurnOff(uint32_t car);
+
+        /* Simulation engine */
+        void step(int32_t dt);
+        void run(uint32_t ticks, int32_t dt);
+
+    private:
+        void writeFlag(uint32_t car, unsigned char flag, bool value);
+
+        /* Disallow copy */
+        CarFleet(const CarFleet&);
+        CarFleet &operator=(const CarFleet&);
+
+    protected:
+        uint32_t count;
+
+        /* Members */
+        unsigned char *accelerator;
+        unsigned char *brake;
+        unsigned char *flags;
+        int32_t *speed;
+        uint32_t *distance;
+        uint32_t *distance_frac;
+};
+
+#endif
@@ -0,0 +1,109 @@
+//************************************************************************
+//
+//  format.h
+//
+//  Defines the FixedField Class template: integer formatting into a
+//  caller buffer, specialized at compile time on the field width and
+//  the padding character.
+//
+//  Same output as printf("%0<Width>i") (or "%<Width>i" with a blank
+//  padding), without the Stream/vfprintf machinery: no format string
+//  parsing, no heap, a few bytes of stack. Values wider than the field
+//  are printed in full, like printf does.
+//
+//  Methods:
+//          -format         writes a signed or unsigned value, returns
+//                          the number of characters (no terminator)
+//
+//  Usage:
+//          char text[FixedField<6>::SIZE];
+//          lcd->write(text, FixedField<6>::format(text, distance));
+//
+//************************************************************************
+#ifndef __FORMAT_H__
+#define __FORMAT_H__
+
+/* Standard includes */
+#include <stdint.h>
+
+template<int Width, char Pad = '0'>
+class FixedField
+{
+    public:
+        /* Largest output: sign and 10 digits, or the width */
+        enum { SIZE = Width > 11 ? Width : 11 };
+
+        /*  Unsigned value */
+        //  @param  buffer  at least SIZE characters
+        //  @return characters written
+        static int format(char *buffer, uint32_t value)
+        {
+            return put(buffer, value, false);
+        }
+
+        /*  Signed value */
+        //  @param  buffer  at least SIZE characters
+        //  @return characters written
+        static int format(char *buffer, int32_t value)
+        {
+            if (value < 0)
+                return put(buffer, 0u - (uint32_t)value, true);
+            return put(buffer, (uint32_t)value, false);
+        }
+
+        /*  Any other integer type, char and int among them */
+        //  @param  buffer  at least SIZE characters
+        //  @return characters written
+        //
+        //  N.B.: int32_t is long on arm-none-eabi, so an int would
+        //        otherwise convert to both overloads above and be
+        //        ambiguous; the host, where int32_t is int, hides it
+        template<typename T>
+        static int format(char *buffer, T value)
+        {
+            if (value < 0)
+                return format(buffer, (int32_t)value);
+            return format(buffer, (uint32_t)value);
+        }
+
+    private:
+        /*  Writes the digits right aligned */
+        //  @brief  digits are produced backwards into a scratch area,
+        //          then copied after the sign and padding
+        static int put(char *buffer, uint32_t value, bool negative)
+        {
+            char digits[10];
+            int count = 0;
+
+            do
+            {
+                digits[count++] = '0' + value % 10;
+                value /= 10;
+            }
+            while (value);
+
+            int length = count + negative;
+            int pad = Width > length ? Width - length : 0;
+            int pos = 0;
+
+            // Zero padding goes after the sign, blank padding before it
+            if (Pad != '0')
+                while (pad > 0)
+                {
+                    buffer[pos++] = Pad;
+                    pad--;
+                }
+            if (negative)
+                buffer[pos++] = '-';
+            while (pad > 0)
+            {
+                buffer[pos++] = '0';
+                pad--;
+            }
+            while (count)
+                buffer[pos++] = digits[--count];
+            return pos;
+        }
+};
+
+#endif
@@ -0,0 +1,208 @@
+//************************************************************************
+//
+//  lcdqueue.cpp
+//
+//  LCDQueue Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "lcdqueue.h"
+
+/* Mbed includes */
+#include "us_ticker_api.h"
+
+/* Standard includes */
+#include <string.h>
+
+/*  Default Constructor */
+//  @param  lcd         display, switched to buffered mode
+//  @param  priority    priority of the renderer thread
+//  @param  stack_size  stack of the renderer thread
+LCDQueue::LCDQueue(WattBob_TextLCD *lcd, osPriority priority, uint32_t stack_size)
+: lcd(lcd),
+  depth(0),
+  max_depth(0),
+  dropped(0),
+  rendered(0),
+  total_latency(0),
+  max_latency(0),
+  refreshes(0),
+  profiler(NULL),
+  profile(-1),
+  _thread(&LCDQueue::threadStarter, this, priority, stack_size)
+{
+    lcd->setBuffered(true);
+}
+
+/*  Posts text */
+//  @param  row, column position of the first character
+//  @param  text        characters, need not be terminated
+//  @param  length      at most DISPLAY_COLUMNS characters are kept
+//  @return false if the queue was full and the text dropped
+bool LCDQueue::write(int row, int column, const char *text, int length)
+{
+    LCDCommand *command = queue.alloc();
+    if (command == NULL)
+        return post(NULL);
+
+    if (length > DISPLAY_COLUMNS)
+        length = DISPLAY_COLUMNS;
+    command->clear = 0;
+    command->row = row;
+    command->column = column;
+    command->length = length;
+    memcpy(command->text, text, length);
+    return post(command);
+}
+
+/*  Posts a clear */
+//  @return false if the queue was full
+bool LCDQueue::cls()
+{
+    LCDCommand *command = queue.alloc();
+    if (command == NULL)
+        return post(NULL);
+
+    command->clear = 1;
+    command->length = 0;
+    return post(command);
+}
+
+/*  Queues a command and updates the depth */
+//  @param  command     NULL counts a drop
+bool LCDQueue::post(LCDCommand *command)
+{
+    __disable_irq();
+    if (command == NULL)
+        dropped++;
+    else if (++depth > max_depth)
+        max_depth = depth;
+    __enable_irq();
+
+    if (command == NULL)
+        return false;
+
+    command->posted = us_ticker_read();
+    queue.put(command);
+    return true;
+}
+
+/*  Thread worker */
+//  @brief  applies every pending command to the framebuffer, then
+//          refreshes the display once for the whole batch
+void LCDQueue::run()
+{
+    uint32_t posted[LCD_QUEUE_SIZE];
+
+    while(1)
+    {
+        osEvent evt = queue.get();
+        int batch = 0;
+        Profiler *timed = profiler;
+        if (timed)
+            timed->begin(profile);
+
+        while (evt.status == osEventMail)
+        {
+            LCDCommand *command = (LCDCommand*)evt.value.p;
+            if (command->clear)
+                lcd->cls();
+            else
+            {
+                lcd->locate(command->row, command->column);
+                lcd->write(command->text, command->length);
+            }
+            posted[batch++] = command->posted;
+            queue.free(command);
+
+            __disable_irq();
+            depth--;
+            __enable_irq();
+
+            if (batch == LCD_QUEUE_SIZE)
+                break;
+            evt = queue.get(0);
+        }
+
+        lcd->flush();
+        refreshes++;
+        if (timed)
+            timed->end(profile);
+
+        uint32_t now = us_ticker_read();
+        for (int i = 0; i < batch; i++)
+        {
+            uint32_t latency = now - posted[i];
+            total_latency += latency;
+            if (latency > max_latency)
+                max_latency = latency;
+        }
+        rendered += batch;
+    }
+}
+
+/*  Standard Accessor */
+//  @return commands posted but not yet applied
+uint32_t LCDQueue::getDepth()
+{
+    return depth;
+}
+
+/*  Standard Accessor */
+uint32_t LCDQueue::getMaxDepth()
+{
+    return max_depth;
+}
+
+/*  Standard Accessor */
+//  @return commands lost to a full queue
+uint32_t LCDQueue::getDropped()
+{
+    return dropped;
+}
+
+/*  Standard Accessor */
+//  @return average post to on-screen time in us
+uint32_t LCDQueue::getLatency()
+{
+    return rendered ? (uint32_t)(total_latency / rendered) : 0;
+}
+
+/*  Standard Accessor */
+//  @return worst post to on-screen time in us
+uint32_t LCDQueue::getMaxLatency()
+{
+    return max_latency;
+}
+
+/*  Standard Accessor */
+//  @return display refreshes, one per drained batch
+uint32_t LCDQueue::getRefreshes()
+{
+    return refreshes;
+}
+
+/*  Standard Accessor */
+//  @return renderer thread, for its stack usage
+Thread &LCDQueue::getThread()
+{
+    return _thread;
+}
+
+/*  Attaches a Profiler */
+//  @param  profiler    table that gets a "lcd render" entry, timing one
+//                      drained batch and its refresh
+void LCDQueue::setProfiler(Profiler *profiler)
+{
+    profile = profiler->add("lcd render");
+    this->profiler = profiler;
+}
+
+/*  Thread static callback */
+//  @brief      Calls run method
+void LCDQueue::threadStarter(void const *p)
+{
+    LCDQueue *instance = (LCDQueue*)p;
+    instance->run();
+}
@@ -0,0 +1,102 @@
+//************************************************************************
+//
+//  lcdqueue.h
+//
+//  Requirements: rtos.h, mbed.h, profiler.h, WattBob_TextLCD.h
+//
+//  Defines an LCDQueue Class: a command queue in front of a
+//  WattBob_TextLCD, drained by a low priority renderer thread.
+//
+//  Any thread posts text at a position, or a clear, without blocking:
+//  the command is copied into an RTOS Mail queue and the call returns.
+//  The renderer applies every pending command to the display's shadow
+//  framebuffer, then flushes once, so bursts of updates coalesce into a
+//  single I2C refresh of the cells that actually changed.
+//
+//  Methods:
+//          -write          posts text at a row/column
+//          -cls            posts a clear
+//          -getDepth       commands waiting, and the worst seen
+//          -getLatency     post to on-screen time, average and worst
+//          -setProfiler    records every render in a Profiler table
+//
+//  Threads:
+//          -_thread        renderer, blocks on the queue
+//
+//************************************************************************
+#ifndef __LCDQUEUE_H__
+#define __LCDQUEUE_H__
+
+/* Mbed & RTOS includes */
+#include "mbed.h"
+#include "rtos.h"
+
+/* Profiler includes */
+#include "profiler.h"
+
+/* Hardware includes */
+#include "WattBob_TextLCD.h"
+
+/* Commands the queue can hold */
+#define LCD_QUEUE_SIZE      16
+
+/* Command posted to the renderer */
+typedef struct {
+    unsigned char clear;
+    unsigned char row;
+    unsigned char column;
+    unsigned char length;
+    char text[DISPLAY_COLUMNS];
+    uint32_t posted;
+} LCDCommand;
+
+class LCDQueue
+{
+    public:
+        /* Default Constructor */
+        LCDQueue(WattBob_TextLCD *lcd, osPriority priority = osPriorityLow,
+                 uint32_t stack_size = 1024);
+
+        /* Static Callback to thread */
+        static void threadStarter(void const *p);
+
+        /* Non-blocking commands */
+        bool write(int row, int column, const char *text, int length);
+        bool cls();
+
+        /* Metrics */
+        uint32_t getDepth();
+        uint32_t getMaxDepth();
+        uint32_t getDropped();
+        uint32_t getLatency();
+        uint32_t getMaxLatency();
+        uint32_t getRefreshes();
+        Thread &getThread();
+        void setProfiler(Profiler *profiler);
+
+    private:
+        void run();
+        bool post(LCDCommand *command);
+
+    protected:
+        /* Members */
+        WattBob_TextLCD *lcd;
+        Mail<LCDCommand, LCD_QUEUE_SIZE> queue;
+
+        /* Updated with interrupts masked, posted from any thread */
+        volatile uint32_t depth;
+        uint32_t max_depth;
+        uint32_t dropped;
+
+        /* Renderer only */
+        uint32_t rendered;
+        uint64_t total_latency;
+        uint32_t max_latency;
+        uint32_t refreshes;
+        Profiler *profiler;
+        int profile;
+
+        Thread _thread;
+};
+
+#endif
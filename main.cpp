@@ -17,24 +17,176 @@
 //  WattBob I
 //
 //  Requirements: MCP23017.h, MCP23017.cpp, WattBob_TextLCD.h WattBob_TextLCD.cpp
-//                car.h, car.cpp, controller.h, controller.cpp, message.h, pinout.h
+//                car.h, car.cpp, controller.h, controller.cpp, executive.h,
+//                executive.cpp, average.h, ring.h, telemetry.h, telemetry.cpp,
+//                asyncserial.h, asyncserial.cpp, format.h, lcdqueue.h,
+//                lcdqueue.cpp, switches.h, switches.cpp, pedals.h,
+//                pedals.cpp, pedalbench.h, pedalbench.cpp, cycles.h,
+//                profiler.h, profiler.cpp, stackmonitor.h, stackmonitor.cpp,
+//                message.h, physics.h, pinout.h
 //
 //
 //************************************************************************
 //
 //  Initialize an object of type Controller
-//  Once the object is fully cunstructed the programm will run 11 main Threads
+//  Once the object is fully cunstructed the programm will run the cyclic
+//  executive thread and the Car simulator thread
+//  While every thread is blocked the RTX idle thread sleeps without the
+//  1ms tick until the next delay expires (RTOS_TICKLESS, rtos_idle.h).
+//  That only saves power without the pedal Ticker: with
+//  PEDAL_OVERSAMPLING its 1600Hz interrupt ends almost every sleep, so
+//  the idle thread keeps the tick and just waits for interrupts instead
 //
 //************************************************************************
 
 /* Class includes */
 #include "controller.h"
+#include "pedalbench.h"
+
+/* 1 makes main() check on target that delayed threads keep running across
+   tickless sleeps, and print the result before the Controller starts */
+#ifndef TICKLESS_TEST
+#define TICKLESS_TEST       0
+#endif
+
+#if TICKLESS_TEST
+#include "rtos_idle.h"
+
+#if !RTOS_TICKLESS
+#error TICKLESS_TEST needs RTOS_TICKLESS
+#endif
+
+/* Tickless test: releases per thread and their spacing, ms */
+#define TICKLESS_RUNS       100
+#define TICKLESS_DELAY_MS   50
+#define TICKLESS_PERIOD_MS  70
+
+/* Releases seen by each test thread */
+static volatile uint32_t tickless_delayed;
+static volatile uint32_t tickless_periodic;
+
+/*  Tickless test thread */
+//  @brief  Thread::wait, the sleep ends on its delay expiry
+static void ticklessDelayed(void const *args)
+{
+    for (int i = 0; i < TICKLESS_RUNS; i++)
+    {
+        Thread::wait(TICKLESS_DELAY_MS);
+        tickless_delayed++;
+    }
+}
+
+/*  Tickless test thread */
+//  @brief  periodic releases, the sleep ends on an interval expiry
+static void ticklessPeriodic(void const *args)
+{
+    osThreadPeriodSet(TICKLESS_PERIOD_MS);
+    for (int i = 0; i < TICKLESS_RUNS; i++)
+    {
+        osThreadPeriodWait();
+        tickless_periodic++;
+    }
+}
+
+/*  Tickless idle test */
+//  @brief  runs two threads whose delays end tickless sleeps, and prints
+//          on the USB serial port whether both got every release on time
+//
+//  N.B.: a thread the idle thread loses stops counting; the test gives up
+//        after twice the expected time
+static void ticklessTest()
+{
+    Serial pc(USBTX, USBRX);
+    Timer timer;
+    rtos_tickless_stats_t before, after;
+    int expected_ms = TICKLESS_RUNS * TICKLESS_PERIOD_MS;
+
+    pc.baud(115200);
+    rtos_tickless_get_stats(&before);
+    timer.start();
+    Thread delayed(ticklessDelayed);
+    Thread periodic(ticklessPeriodic);
+    while ((tickless_delayed < TICKLESS_RUNS || tickless_periodic < TICKLESS_RUNS) &&
+           timer.read_ms() < 2 * expected_ms)
+        Thread::wait(TICKLESS_DELAY_MS);
+    int elapsed_ms = timer.read_ms();
+    rtos_tickless_get_stats(&after);
+
+    bool pass = tickless_delayed == TICKLESS_RUNS &&
+                tickless_periodic == TICKLESS_RUNS &&
+                after.sleeps != before.sleeps &&
+                elapsed_ms < expected_ms + TICKLESS_DELAY_MS;
+    pc.printf("tickless idle, %d ms: delayed %u/%u, periodic %u/%u\r\n",
+              elapsed_ms, tickless_delayed, TICKLESS_RUNS,
+              tickless_periodic, TICKLESS_RUNS);
+    pc.printf("  %u sleeps, %u ticks skipped, %u early: %s\r\n",
+              after.sleeps - before.sleeps,
+              after.ticks_skipped - before.ticks_skipped,
+              after.early_wakeups - before.early_wakeups,
+              pass ? "PASS" : "FAIL");
+}
+#endif
+
+#if PEDAL_OVERSAMPLING
+/*  Idle hook with the pedal Ticker */
+//  @brief  sleeps until the next interrupt, the tick running
+//
+//  N.B.:   the 1600Hz Ticker ends nearly every tickless sleep, which then
+//          costs more than it saves: in 60s carsim -i has 94800 sleeps
+//          ending early for 1800 releases, 1.73% awake against 1.42%
+//          for this hook
+static void tickingIdle()
+{
+    __WFI();
+}
+#endif
+
+#if PEDAL_BENCHMARK
+#include "cycles.h"
+
+/*  Pedal scaling benchmark */
+//  @brief  prints the float and integer cost of one updateCommands tick
+//          on the USB serial port, before the Controller claims it
+static void pedalBenchmark()
+{
+    Serial pc(USBTX, USBRX);
+    AnalogIn accelerator(p17);
+    AnalogIn brake(p16);
+    PedalBenchmark result;
+
+    pc.baud(115200);
+    benchmarkPedals(accelerator, brake, 1000, result);
+    pc.printf("pedal scaling, %u ticks, " CYCLES_UNIT " per tick\r\n", result.ticks);
+    pc.printf("  float    avg %u min %u\r\n",
+              result.float_total / result.ticks, result.float_min);
+    pc.printf("  integer  avg %u min %u\r\n",
+              result.integer_total / result.ticks, result.integer_min);
+    pc.printf("  %u ticks off by one count\r\n", result.mismatches);
+
+    PedalSweep sweep;
+    sweepPedalCodes(sweep);
+    pc.printf("  %u of %u codes differ (%u integer higher), by %u count at most\r\n",
+              sweep.mismatches, sweep.codes, sweep.integer_higher, sweep.max_difference);
+}
+#endif
 
 int main() 
 {
+#if TICKLESS_TEST
+    ticklessTest();
+#endif
+#if PEDAL_BENCHMARK
+    pedalBenchmark();
+#endif
+    
+#if PEDAL_OVERSAMPLING
+    Thread::attach_idle_hook(tickingIdle);
+#endif
+
     /* Declare an object of Controller Class */
     Controller CarController;
     
-    /* Waits forever */
-    while (1);
+    /* Waits forever, blocked so the idle thread can stop the tick */
+    while (1)
+        Thread::wait(osWaitForever);
 }
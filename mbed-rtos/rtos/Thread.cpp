@@ -28,6 +28,7 @@ namespace rtos {
 
 Thread::Thread(void (*task)(void const *argument), void *argument,
         osPriority priority, uint32_t stack_size, unsigned char *stack_pointer) {
+    _overruns = 0;
 #ifdef CMSIS_OS_RTX
     _thread_def.pthread = task;
     _thread_def.tpriority = priority;
@@ -117,6 +118,22 @@ uint32_t Thread::max_stack() {
 #endif
 }
 
+osStatus Thread::period_set(uint32_t millisec) {
+    _overruns = 0;
+    return osThreadPeriodSet(millisec);
+}
+
+osStatus Thread::period_wait() {
+    osStatus status = osThreadPeriodWait();
+    if (status == osOK)
+        _overruns++;
+    return status;
+}
+
+uint32_t Thread::overruns() {
+    return _overruns;
+}
+
 osEvent Thread::signal_wait(int32_t signals, uint32_t millisec) {
     return osSignalWait(signals, millisec);
 }
@@ -109,6 +109,28 @@ public:
     */
     uint32_t max_stack();
 
+    /** Start periodic releases of this thread, the first one millisec from now.
+      Releases stay on a fixed grid whatever the execution time (RTX interval wait).
+      @param   millisec  release period in millisec.
+      @return  status code that indicates the execution status of the function.
+      @note    Must be called by this thread. Other timed waits of the thread
+               (wait(), timeouts) between two releases move the grid.
+    */
+    osStatus period_set(uint32_t millisec);
+
+    /** Wait for the next periodic release of this thread.
+      A release already past returns at once and counts as an overrun; the
+      following releases stay on the grid, so a late thread catches up.
+      @return  osEventTimeout on time, osOK on an overrun, or an error code.
+      @note    Must be called by this thread.
+    */
+    osStatus period_wait();
+
+    /** Get the number of releases found already past by period_wait()
+      @return  missed deadlines since period_set()
+    */
+    uint32_t overruns();
+
     /** Wait for one or more Signal Flags to become signaled for the current RUNNING thread.
       @param   signals   wait until all specified signal flags set or 0 for any single signal flag.
       @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever).
@@ -143,6 +165,7 @@ private:
     osThreadId _tid;
     osThreadDef_t _thread_def;
     bool _dynamic_stack;
+    uint32_t _overruns;
 };
 
 }
@@ -22,13 +22,121 @@
 
 #include "rtos_idle.h"
 
+#if RTOS_TICKLESS
+#include "cmsis.h"
+#include "cmsis_os.h"
+#include "rtos_tickless.h"
+
+/* RTX kernel */
+extern int os_tick_irqn;
+extern uint32_t const os_trv;
+
+/* SysTick control bits */
+#define TICK_ENABLE     (SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk)
+#define TICK_STOPPED    SysTick_CTRL_CLKSOURCE_Msk
+
+/* Cycles before a tick boundary inside which the idle loop does not sleep,
+   so no boundary can go by while the tick is being reprogrammed; a boundary
+   this close after a sleep is counted with it */
+#define TICKLESS_GUARD  1024
+
+/* Tickless idle statistics */
+static rtos_tickless_stats_t tickless_stats;
+
+/* Stretch the SysTick to the next delay expiry, WFI, then tell RTX how many
+   ticks went by. Suspend and resume are service calls, so a thread made
+   ready by the resume is switched to on SVC exit; PRIMASK is only set in
+   between, around the reprogram and the WFI (an SVC with PRIMASK set
+   escalates to HardFault). While suspended the tick interrupt is locked
+   out: a boundary going by then sets COUNTFLAG and is counted on resume.
+   The counter is stopped for a few cycles per sleep, which RTX time loses. */
+static void tickless_idle(void)
+{
+    uint32_t period = os_trv + 1;
+    uint32_t ticks, first, cycles, current, elapsed, passed, next, ctrl;
+
+    if (os_tick_irqn >= 0 ||
+        (SCB->ICSR & (SCB_ICSR_PENDSVSET_Msk | SCB_ICSR_PENDSTSET_Msk)))
+        return;
+
+    ticks = osKernelSuspend();
+
+    passed = 0;
+    __disable_irq();
+    if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
+        /* A boundary went by since the lock, RTX sees it on resume */
+        passed = 1;
+    } else if (ticks < 2 || osKernelSuspendPending() ||
+               SysTick->VAL < TICKLESS_GUARD) {
+        /* Let a close boundary go by here rather than after the resume
+           call has read COUNTFLAG */
+        if (SysTick->VAL < TICKLESS_GUARD) {
+            while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk))
+                ;
+            passed = 1;
+        }
+    } else {
+        SysTick->CTRL = TICK_STOPPED;
+        first = SysTick->VAL;
+        if (ticks > tickless_limit(first, period))
+            ticks = tickless_limit(first, period);
+        cycles = tickless_cycles(first, ticks, period);
+
+        /* Writing VAL also clears COUNTFLAG */
+        SysTick->LOAD = cycles - 1;
+        SysTick->VAL = 0;
+        SysTick->CTRL = TICK_ENABLE | SysTick_CTRL_TICKINT_Msk;
+        __DSB();
+        __WFI();
+
+        SysTick->CTRL = TICK_STOPPED;
+        ctrl = SysTick->CTRL;
+        current = SysTick->VAL;
+        if (ctrl & SysTick_CTRL_COUNTFLAG_Msk)
+            elapsed = cycles + (current ? cycles - current : 0);
+        else
+            elapsed = current ? cycles - current : 0;
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+        /* Restart in phase with the tick boundaries, the tick interrupt
+           stays locked out until the resume call */
+        passed = tickless_passed(first, elapsed, period, &next);
+        if (next < TICKLESS_GUARD) {
+            passed++;
+            next += period;
+        }
+        SysTick->LOAD = next - 1;
+        SysTick->VAL = 0;
+        SysTick->CTRL = TICK_ENABLE;
+        SysTick->LOAD = os_trv;
+
+        tickless_stats.sleeps++;
+        tickless_stats.ticks_skipped += passed;
+        if (passed < ticks)
+            tickless_stats.early_wakeups++;
+    }
+    __enable_irq();
+
+    osKernelResume(passed);
+}
+
+void rtos_tickless_get_stats(rtos_tickless_stats_t *stats)
+{
+    *stats = tickless_stats;
+}
+#endif
+
 static void default_idle_hook(void)
 {
+#if RTOS_TICKLESS
+    tickless_idle();
+#else
     /* Sleep: ideally, we should put the chip to sleep.
      Unfortunately, this usually requires disconnecting the interface chip (debugger).
      This can be done, but it would break the local file system.
     */
     // sleep();
+#endif
 }
 static void (*idle_hook_fptr)(void) = &default_idle_hook;
 
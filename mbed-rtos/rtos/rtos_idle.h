@@ -23,13 +23,34 @@
 #define RTOS_IDLE_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Tickless idle: the default idle hook stops the RTX tick and sleeps until
+   the next delay expiry (see rtos_tickless.h). Only with the SysTick as the
+   RTX tick; define RTOS_TICKLESS to 0 to keep the tick running.
+   It only saves power when delays end the sleeps: an interrupt firing
+   every few ticks (a fast Ticker) ends them early, and an idle hook that
+   just waits for interrupts with the tick running then costs less. */
+#ifndef RTOS_TICKLESS
+#define RTOS_TICKLESS   1
+#endif
+
 void rtos_attach_idle_hook(void (*fptr)(void));
 
+#if RTOS_TICKLESS
+typedef struct {
+    uint32_t sleeps;            /* WFI entered with the tick stretched */
+    uint32_t ticks_skipped;     /* tick interrupts replaced by the sleeps */
+    uint32_t early_wakeups;     /* sleeps ended by another interrupt */
+} rtos_tickless_stats_t;
+
+void rtos_tickless_get_stats(rtos_tickless_stats_t *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
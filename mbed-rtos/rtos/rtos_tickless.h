@@ -0,0 +1,73 @@
+/* Tickless idle arithmetic
+ *
+ * The SysTick counts down from its reload value to 0 and raises the RTX
+ * tick on 0; a tick period is TICK = os_trv + 1 core cycles. When the
+ * idle thread finds the next delay expiry several ticks away, it stops
+ * the tick, sleeps across the whole interval with one long reload, then
+ * tells RTX how many tick boundaries went by (osKernelResume) and restarts
+ * the tick in phase with the boundaries it would have produced.
+ *
+ * These helpers hold the cycle arithmetic only, so the host build can
+ * check it against a ticking kernel.
+ */
+#ifndef RTOS_TICKLESS_H
+#define RTOS_TICKLESS_H
+
+#include <stdint.h>
+
+/* Largest SysTick reload, the counter is 24 bits wide */
+#define TICKLESS_MAX_RELOAD     0xFFFFFF
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Ticks the counter can sleep across in one reload
+  @param   current  cycles left to the next tick boundary
+  @param   period   cycles per tick
+  @return  boundaries reachable, at least 1
+*/
+static __inline uint32_t tickless_limit(uint32_t current, uint32_t period)
+{
+    if (current > TICKLESS_MAX_RELOAD + 1)
+        return 1;
+    return 1 + (TICKLESS_MAX_RELOAD + 1 - current) / period;
+}
+
+/** Length of a sleep ending on a tick boundary
+  @param   current  cycles left to the next tick boundary
+  @param   ticks    boundary to wake on, 1 is the next one
+  @param   period   cycles per tick
+  @return  cycles to sleep, the reload value is this minus 1
+*/
+static __inline uint32_t tickless_cycles(uint32_t current, uint32_t ticks, uint32_t period)
+{
+    return current + (ticks - 1) * period;
+}
+
+/** Ticks gone by during a sleep
+  @param   current  cycles that were left to the next boundary at sleep time
+  @param   elapsed  cycles slept
+  @param   period   cycles per tick
+  @param   next     set to the cycles left to the following boundary
+  @return  tick boundaries crossed, a boundary reached exactly counts
+*/
+static __inline uint32_t tickless_passed(uint32_t current, uint32_t elapsed,
+                                         uint32_t period, uint32_t *next)
+{
+    uint32_t late;
+
+    if (elapsed < current) {
+        *next = current - elapsed;
+        return 0;
+    }
+    late = elapsed - current;
+    *next = period - late % period;
+    return 1 + late / period;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
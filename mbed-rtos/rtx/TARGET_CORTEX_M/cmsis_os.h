@@ -404,6 +404,66 @@ os_InRegs osEvent osWait (uint32_t millisec);
 #endif  // Generic Wait available
 
 
+//  ==== Periodic Wait Functions (mbed extension) ====
+
+/// Start periodic releases of the running thread, the first one \a millisec from now.
+/// Built on the RTX interval wait: releases stay on a fixed grid, whatever the execution time.
+/// \param[in]     millisec      release period, less than 32768 ticks.
+/// \return status code that indicates the execution status of the function.
+/// \note Other timed waits of the same thread between two releases move the grid.
+osStatus osThreadPeriodSet (uint32_t millisec);
+
+/// Wait for the next periodic release of the running thread.
+/// A release already past returns at once and the next one stays on the grid.
+/// \return \ref osEventTimeout after waiting for the release, \ref osOK if it was already past,
+///         \ref osErrorResource if osThreadPeriodSet was not called.
+osStatus osThreadPeriodWait (void);
+
+
+//  ==== Tickless Idle Functions (mbed extension) ====
+
+/// Lock out the RTX tick, for the idle thread to sleep across several ticks.
+/// Every call must be followed by \ref osKernelResume.
+/// \return ticks to the next delay or timer expiry, 0xFFFF when none is due, 0 from an ISR.
+/// \note A tick boundary going by after the call sets the SysTick COUNTFLAG, which
+///       \ref osKernelResume counts.
+uint32_t osKernelSuspend (void);
+
+/// Advance RTX time by the ticks slept and unlock the RTX tick.
+/// Threads due in the meantime are made ready; the switch to them happens on return.
+/// \param[in]     sleep_time    tick boundaries that went by since \ref osKernelSuspend.
+/// \return status code that indicates the execution status of the function.
+osStatus osKernelResume (uint32_t sleep_time);
+
+/// Check for work held back while the RTX tick is locked out.
+/// \return non-zero when a tick or an ISR request waits for \ref osKernelResume.
+int32_t osKernelSuspendPending (void);
+
+
+//  ==== Stack Usage Functions (mbed extension) ====
+
+/// Get the thread ID of the RTX idle thread.
+/// \return thread ID of the idle thread.
+osThreadId osThreadGetIdleId (void);
+
+/// Get the thread ID of the RTX timer thread.
+/// \return thread ID of the timer thread, NULL before osKernelStart or without user timers.
+osThreadId osThreadGetTimerId (void);
+
+/// Get the stack size of a thread.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return stack size in bytes, 0 for an invalid thread ID.
+uint32_t osThreadStackSize (osThreadId thread_id);
+
+/// Get the deepest stack use of a thread since it was created.
+/// The stack must have been filled with the stack check pattern before the thread
+/// was created: mbed Thread objects and the idle and timer threads are.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return bytes from the top of the stack down to the deepest word written, 0 for an invalid thread ID.
+/// \note The main thread shares its stack with the heap and is not filled.
+uint32_t osThreadStackMax (osThreadId thread_id);
+
+
 //  ==== Timer Management Functions ====
 /// Define a Timer object.
 /// \param         name          name of the timer object.
@@ -60,6 +60,9 @@
 #include "rt_Mailbox.h"
 #include "rt_MemBox.h"
 #include "rt_HAL_CM.h"
+#if OS_DLY_WHEEL
+#include "rt_DlyWheel.h"
+#endif
 
 #define os_thread_cb OS_TCB
 
@@ -146,6 +149,7 @@ typedef uint32_t __attribute__((vector_size(16))) ret128;
 
 #define RET_pointer    __r0
 #define RET_int32_t    __r0
+#define RET_uint32_t   __r0
 #define RET_osStatus   __r0
 #define RET_osPriority __r0
 #define RET_osEvent    {(osStatus)__r0, {(uint32_t)__r1}, {(void *)__r2}}
@@ -443,6 +447,10 @@ osStatus svcKernelStart (void) {
 
   // Create OS Timers resources (Message Queue & Thread)
   osMessageQId_osTimerMessageQ = svcMessageCreate (&os_messageQ_def_osTimerMessageQ, NULL);
+  if (os_thread_def_osTimerThread.stack_pointer != NULL) {
+    rt_stk_fill (os_thread_def_osTimerThread.stack_pointer,
+                 os_thread_def_osTimerThread.stacksize);
+  }
   osThreadId_osTimerThread = svcThreadCreate(&os_thread_def_osTimerThread, NULL);
 
   rt_tsk_prio(0, 0);                            // Lowest priority
@@ -747,6 +755,142 @@ os_InRegs osEvent osWait (uint32_t millisec) {
 }
 
 
+// ==== Periodic Wait Functions (mbed extension) ====
+
+// Periodic Wait Service Calls declarations
+SVC_1_1(svcThreadPeriodSet,  osStatus, uint32_t, RET_osStatus)
+SVC_0_1(svcThreadPeriodWait, osStatus,           RET_osStatus)
+
+// Periodic Wait Service Calls
+
+/// Start periodic releases of the running thread
+osStatus svcThreadPeriodSet (uint32_t millisec) {
+  uint32_t ticks;
+
+  ticks = rt_ms2tick(millisec);
+  if ((ticks == 0) || (ticks >= 0x8000)) return osErrorValue;
+  rt_itv_set((U16)ticks);
+  return osOK;
+}
+
+/// Wait for the next periodic release of the running thread
+osStatus svcThreadPeriodWait (void) {
+  U16 delta;
+
+  if (os_tsk.run->interval_time == 0) return osErrorResource;
+  delta = os_tsk.run->delta_time - (U16)os_time;
+  rt_itv_wait();
+  if (delta & 0x8000) return osOK;              // Release already past
+  return osEventTimeout;
+}
+
+
+// Periodic Wait API
+
+/// Start periodic releases of the running thread
+osStatus osThreadPeriodSet (uint32_t millisec) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadPeriodSet(millisec);
+}
+
+/// Wait for the next periodic release of the running thread
+osStatus osThreadPeriodWait (void) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadPeriodWait();
+}
+
+
+// ==== Tickless Idle Functions (mbed extension) ====
+
+// Tickless Idle Service Calls declarations
+SVC_0_1(svcKernelSuspend, uint32_t,           RET_uint32_t)
+SVC_1_1(svcKernelResume,  osStatus, uint32_t, RET_osStatus)
+
+// Tickless Idle Service Calls
+
+/// Lock out the RTX tick and get the ticks to the next timeout
+uint32_t svcKernelSuspend (void) {
+  uint32_t ticks;
+
+  __disable_irq();                              // Lock and clear in one step:
+  ticks = rt_suspend();                         // a tick due before is held pending,
+  if (os_tick_irqn < 0) (void)NVIC_ST_CTRL;     // one after sets COUNTFLAG again
+  __enable_irq();
+  return ticks;
+}
+
+/// Account for the ticks slept and unlock the RTX tick
+osStatus svcKernelResume (uint32_t sleep_time) {
+
+  __disable_irq();
+  if ((os_tick_irqn < 0) && (NVIC_ST_CTRL & (1 << 16))) {
+    sleep_time++;                               // Boundary went by under the lock
+  }
+  rt_resume(sleep_time);                        // Switch happens on SVC exit
+  __enable_irq();
+  return osOK;
+}
+
+
+// Tickless Idle API
+
+/// Lock out the RTX tick and get the ticks to the next timeout
+uint32_t osKernelSuspend (void) {
+  if (__get_IPSR() != 0) return 0;              // Not allowed in ISR
+  return __svcKernelSuspend();
+}
+
+/// Account for the ticks slept and unlock the RTX tick
+osStatus osKernelResume (uint32_t sleep_time) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcKernelResume(sleep_time);
+}
+
+/// Check for work the tick lock holds back
+int32_t osKernelSuspendPending (void) {
+  return (int32_t)rt_lock_pending();
+}
+
+
+// ==== Stack Usage Functions (mbed extension) ====
+
+// Stack Usage API, read only: no service call
+
+/// Get the thread ID of the idle thread
+osThreadId osThreadGetIdleId (void) {
+  return &os_idle_TCB;
+}
+
+/// Get the thread ID of the timer thread
+osThreadId osThreadGetTimerId (void) {
+  return osThreadId_osTimerThread;
+}
+
+/// Get the stack size of a thread
+uint32_t osThreadStackSize (osThreadId thread_id) {
+  P_TCB ptcb;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return 0;
+  return ptcb->priv_stack;
+}
+
+/// Get the deepest stack use of a thread
+uint32_t osThreadStackMax (osThreadId thread_id) {
+  P_TCB ptcb;
+  U32   size,i;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return 0;
+  size = ptcb->priv_stack >> 2;
+  i = 0;
+  while ((i < size) && (ptcb->stack[i] == MAGIC_WORD)) {
+    i++;
+  }
+  return ((size - i) << 2);
+}
+
+
 // ==== Timer Management ====
 
 // Timer definitions
@@ -758,21 +902,40 @@ os_InRegs osEvent osWait (uint32_t millisec) {
 
 typedef struct os_timer_cb_ {                   // Timer Control Block
   struct os_timer_cb_ *next;                    // Pointer to next active Timer
+  uint16_t             tcnt;                    // Timer Delay Count (expiry tick in the wheel)
   uint8_t             state;                    // Timer State
   uint8_t              type;                    // Timer Type (Periodic/One-shot)
-  uint16_t         reserved;                    // Reserved
-  uint16_t             tcnt;                    // Timer Delay Count
   uint16_t             icnt;                    // Timer Initial Count
+  uint16_t         reserved;                    // Reserved
   void                 *arg;                    // Timer Function Argument
   osTimerDef_t       *timer;                    // Pointer to Timer definition
 } os_timer_cb;
 
 // Timer variables
+#if OS_DLY_WHEEL
+// 'next' and 'tcnt' lead the Timer Control Block as in struct OS_TMR
+static struct OS_TMRWHEEL os_timer_wheel;       // Active Timers by expiry tick
+#else
 os_timer_cb *os_timer_head;                     // Pointer to first active Timer
+#endif
 
 
 // Timer Helper Functions
 
+#if OS_DLY_WHEEL
+
+// Insert Timer into the wheel, due in tcnt ticks
+static void rt_timer_insert (os_timer_cb *pt, uint32_t tcnt) {
+  rt_twheel_put(&os_timer_wheel, (P_TMR)pt, (uint16_t)(os_time + tcnt));
+}
+
+// Remove Timer from the wheel
+static int rt_timer_remove (os_timer_cb *pt) {
+  return rt_twheel_rmv(&os_timer_wheel, (P_TMR)pt);
+}
+
+#else
+
 // Insert Timer into the list sorted by time
 static void rt_timer_insert (os_timer_cb *pt, uint32_t tcnt) {
   os_timer_cb *p, *prev;
@@ -821,6 +984,8 @@ static int rt_timer_remove (os_timer_cb *pt) {
   return 0;
 }
 
+#endif
+
 
 // Timer Service Calls declarations
 SVC_3_1(svcTimerCreate,           osTimerId,  osTimerDef_t *, os_timer_type, void *, RET_pointer)
@@ -960,6 +1125,20 @@ os_InRegs osCallback_type svcTimerCall (osTimerId timer_id) {
 static __INLINE osStatus isrMessagePut (osMessageQId queue_id, uint32_t info, uint32_t millisec);
 
 /// Timer Tick (called each SysTick)
+#if OS_DLY_WHEEL
+void sysTimerTick (void) {
+  os_timer_cb *pt;
+
+  while ((pt = (os_timer_cb *)rt_twheel_get(&os_timer_wheel, (uint16_t)os_time)) != NULL) {
+    isrMessagePut(osMessageQId_osTimerMessageQ, (uint32_t)pt, 0);
+    if (pt->type == osTimerPeriodic) {
+      rt_timer_insert(pt, pt->icnt);
+    } else {
+      pt->state = osTimerStopped;
+    }
+  }
+}
+#else
 void sysTimerTick (void) {
   os_timer_cb *pt, *p;
 
@@ -979,6 +1158,36 @@ void sysTimerTick (void) {
     }
   }
 }
+#endif
+
+
+/// Get the time until the first user timer expires (tickless idle)
+uint32_t sysUserTimerWakeupTime (void) {
+
+#if OS_DLY_WHEEL
+  return rt_twheel_next(&os_timer_wheel, (uint16_t)os_time);
+#else
+  if (os_timer_head == NULL) return 0xFFFF;
+  return os_timer_head->tcnt;
+#endif
+}
+
+#if !OS_DLY_WHEEL
+/// Advance the user timers after a tickless sleep
+void sysUserTimerUpdate (uint32_t sleep_time) {
+
+  while ((os_timer_head != NULL) && (sleep_time != 0)) {
+    if (sleep_time >= os_timer_head->tcnt) {
+      sleep_time -= os_timer_head->tcnt;
+      os_timer_head->tcnt = 1;
+      sysTimerTick();
+    } else {
+      os_timer_head->tcnt -= (uint16_t)sleep_time;
+      break;
+    }
+  }
+}
+#endif
 
 
 // Timer Management Public API
@@ -0,0 +1,191 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_DLYWHEEL.H
+ *      Purpose: Timing wheels of the delay list and the user timers
+ *----------------------------------------------------------------------------
+ *
+ * A timing wheel replaces the delta sorted delay chain: every waiting
+ * task keeps its absolute expiry tick in 'delta_time' and is chained into
+ * the slot of that tick modulo OS_DLY_SLOTS. Putting and removing a task
+ * is O(1); each tick visits one slot and releases the tasks of that slot
+ * whose expiry is the current tick, so a slot also holds tasks due one or
+ * more turns of the wheel later. Expiries are compared for equality, so
+ * the full 0xFFFE tick range of a delay is kept as long as every tick is
+ * visited.
+ *
+ * Tasks due on the same tick are released newest first, as the delay
+ * chain did. The first task of a slot has its 'p_blnk' pointing at the
+ * wheel, so 'p_blnk' stays non-NULL for every enqueued task.
+ *
+ * The user timer wheel is the same with a singly linked 'OS_TMR' chain
+ * (next, tcnt) per slot; timers due on the same tick keep their start
+ * order, as the sorted timer list did, so putting and removing a timer
+ * walks its slot.
+ *
+ * The functions only touch the wheel given to them, so the host build can
+ * run them against the delay chain.
+ *---------------------------------------------------------------------------*/
+
+/* Definitions */
+#define OS_DLY_MASK     (OS_DLY_SLOTS - 1)
+
+/* Functions */
+
+__inline static void rt_wheel_put (P_DLYWHEEL p_wheel, P_TCB p_task, U16 expiry) {
+  /* Put task "p_task" into the wheel, due on tick "expiry".                */
+  P_TCB *p_slot;
+
+  p_slot = &p_wheel->slot[expiry & OS_DLY_MASK];
+  p_task->delta_time = expiry;
+  p_task->p_dlnk = *p_slot;
+  p_task->p_blnk = (P_TCB)p_wheel;
+  if (*p_slot != NULL) {
+    (*p_slot)->p_blnk = p_task;
+  }
+  *p_slot = p_task;
+  p_wheel->count++;
+}
+
+
+__inline static void rt_wheel_rmv (P_DLYWHEEL p_wheel, P_TCB p_task) {
+  /* Remove task "p_task", enqueued in the wheel.                          */
+  if (p_task->p_blnk == (P_TCB)p_wheel) {
+    p_wheel->slot[p_task->delta_time & OS_DLY_MASK] = p_task->p_dlnk;
+  }
+  else {
+    p_task->p_blnk->p_dlnk = p_task->p_dlnk;
+  }
+  if (p_task->p_dlnk != NULL) {
+    p_task->p_dlnk->p_blnk = p_task->p_blnk;
+    p_task->p_dlnk = NULL;
+  }
+  p_task->p_blnk = NULL;
+  p_wheel->count--;
+}
+
+
+__inline static P_TCB rt_wheel_get (P_DLYWHEEL p_wheel, U16 time) {
+  /* Remove and return the next task due on tick "time", NULL if none.     */
+  P_TCB p_task;
+
+  for (p_task = p_wheel->slot[time & OS_DLY_MASK]; p_task != NULL; p_task = p_task->p_dlnk) {
+    if (p_task->delta_time == time) {
+      rt_wheel_rmv (p_wheel, p_task);
+      return (p_task);
+    }
+  }
+  return (NULL);
+}
+
+
+__inline static U32 rt_wheel_next (P_DLYWHEEL p_wheel, U16 time) {
+  /* Ticks from "time" to the first expiry, 0xFFFF if the wheel is empty.  */
+  P_TCB p_task;
+  U32 i,dist,best;
+
+  if (p_wheel->count == 0) {
+    return (0xFFFF);
+  }
+  for (i = 1; i <= OS_DLY_SLOTS; i++) {
+    for (p_task = p_wheel->slot[(time + i) & OS_DLY_MASK]; p_task != NULL; p_task = p_task->p_dlnk) {
+      if (p_task->delta_time == (U16)(time + i)) {
+        return (i);
+      }
+    }
+  }
+  /* Nothing due within one turn: look at every task */
+  best = 0xFFFF;
+  for (i = 0; i < OS_DLY_SLOTS; i++) {
+    for (p_task = p_wheel->slot[i]; p_task != NULL; p_task = p_task->p_dlnk) {
+      dist = (U16)(p_task->delta_time - time);
+      if (dist < best) {
+        best = dist;
+      }
+    }
+  }
+  return (best);
+}
+
+
+__inline static void rt_twheel_put (P_TMRWHEEL p_wheel, P_TMR p_tmr, U16 expiry) {
+  /* Put timer "p_tmr" at the end of its slot, due on tick "expiry".        */
+  P_TMR *p_next;
+
+  p_next = &p_wheel->slot[expiry & OS_DLY_MASK];
+  while (*p_next != NULL) {
+    p_next = &(*p_next)->next;
+  }
+  p_tmr->tcnt = expiry;
+  p_tmr->next = NULL;
+  *p_next = p_tmr;
+  p_wheel->count++;
+}
+
+
+__inline static int rt_twheel_rmv (P_TMRWHEEL p_wheel, P_TMR p_tmr) {
+  /* Remove timer "p_tmr"; -1 if it is not in the wheel.                   */
+  P_TMR *p_next;
+
+  p_next = &p_wheel->slot[p_tmr->tcnt & OS_DLY_MASK];
+  while (*p_next != NULL) {
+    if (*p_next == p_tmr) {
+      *p_next = p_tmr->next;
+      p_wheel->count--;
+      return (0);
+    }
+    p_next = &(*p_next)->next;
+  }
+  return (-1);
+}
+
+
+__inline static P_TMR rt_twheel_get (P_TMRWHEEL p_wheel, U16 time) {
+  /* Remove and return the next timer due on tick "time", NULL if none.    */
+  P_TMR *p_next,p_tmr;
+
+  p_next = &p_wheel->slot[time & OS_DLY_MASK];
+  while ((p_tmr = *p_next) != NULL) {
+    if (p_tmr->tcnt == time) {
+      *p_next = p_tmr->next;
+      p_wheel->count--;
+      return (p_tmr);
+    }
+    p_next = &p_tmr->next;
+  }
+  return (NULL);
+}
+
+
+__inline static U32 rt_twheel_next (P_TMRWHEEL p_wheel, U16 time) {
+  /* Ticks from "time" to the first expiry, 0xFFFF if the wheel is empty.  */
+  P_TMR p_tmr;
+  U32 i,dist,best;
+
+  if (p_wheel->count == 0) {
+    return (0xFFFF);
+  }
+  for (i = 1; i <= OS_DLY_SLOTS; i++) {
+    for (p_tmr = p_wheel->slot[(time + i) & OS_DLY_MASK]; p_tmr != NULL; p_tmr = p_tmr->next) {
+      if (p_tmr->tcnt == (U16)(time + i)) {
+        return (i);
+      }
+    }
+  }
+  /* Nothing due within one turn: look at every timer */
+  best = 0xFFFF;
+  for (i = 0; i < OS_DLY_SLOTS; i++) {
+    for (p_tmr = p_wheel->slot[i]; p_tmr != NULL; p_tmr = p_tmr->next) {
+      dist = (U16)(p_tmr->tcnt - time);
+      if (dist < best) {
+        best = dist;
+      }
+    }
+  }
+  return (best);
+}
+
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -39,6 +39,15 @@
 #include "rt_Task.h"
 #include "rt_Time.h"
 #include "rt_HAL_CM.h"
+#if OS_RDY_BITMAP
+#if (__TARGET_ARCH_6S_M)
+ #error "OS_RDY_BITMAP needs CLZ, not available on ARMv6-M"
+#endif
+#include "rt_RdyMap.h"
+#endif
+#if OS_DLY_WHEEL
+#include "rt_DlyWheel.h"
+#endif
 
 /*----------------------------------------------------------------------------
  *      Global Variables
@@ -48,6 +57,14 @@
 struct OS_XCB  os_rdy;
 /* List head of chained delay tasks */
 struct OS_XCB  os_dly;
+#if OS_RDY_BITMAP
+/* Priority index of the ready list */
+struct OS_RDYMAP os_rdy_map;
+#endif
+#if OS_DLY_WHEEL
+/* Timing wheel of delayed tasks */
+struct OS_DLYWHEEL os_dly_wheel;
+#endif
 
 
 /*----------------------------------------------------------------------------
@@ -65,6 +82,12 @@ void rt_put_prio (P_XCB p_CB, P_TCB p_task) {
   U32 prio;
   BOOL sem_mbx = __FALSE;
 
+#if OS_RDY_BITMAP
+  if (p_CB == &os_rdy) {
+    rt_map_put (&os_rdy, &os_rdy_map, p_task);
+    return;
+  }
+#endif
   if (p_CB->cb_type == SCB || p_CB->cb_type == MCB || p_CB->cb_type == MUCB) {
     sem_mbx = __TRUE;
   }
@@ -108,6 +131,11 @@ P_TCB rt_get_first (P_XCB p_CB) {
   }
   else {
     p_first->p_lnk = NULL;
+#if OS_RDY_BITMAP
+    if (p_CB == &os_rdy) {
+      rt_map_head_out (&os_rdy_map, p_first);
+    }
+#endif
   }
   return (p_first);
 }
@@ -121,6 +149,9 @@ void rt_put_rdy_first (P_TCB p_task) {
   p_task->p_lnk = os_rdy.p_lnk;
   p_task->p_rlnk = NULL;
   os_rdy.p_lnk = p_task;
+#if OS_RDY_BITMAP
+  rt_map_head_in (&os_rdy_map, p_task);
+#endif
 }
 
 
@@ -134,6 +165,9 @@ P_TCB rt_get_same_rdy_prio (void) {
   p_first = os_rdy.p_lnk;
   if (p_first->prio == os_tsk.run->prio) {
     os_rdy.p_lnk = os_rdy.p_lnk->p_lnk;
+#if OS_RDY_BITMAP
+    rt_map_head_out (&os_rdy_map, p_first);
+#endif
     return (p_first);
   }
   return (NULL);
@@ -167,6 +201,13 @@ res:rt_rmv_list (p_task);
 
 /*--------------------------- rt_put_dly ------------------------------------*/
 
+#if OS_DLY_WHEEL
+void rt_put_dly (P_TCB p_task, U16 delay) {
+  /* Put a task identified with "p_task" into the delay wheel using a      */
+  /* delay value of "delay".                                                */
+  rt_wheel_put (&os_dly_wheel, p_task, (U16)(os_time + delay));
+}
+#else
 void rt_put_dly (P_TCB p_task, U16 delay) {
   /* Put a task identified with "p_task" into chained delay wait list using */
   /* a delay value of "delay".                                              */
@@ -203,10 +244,36 @@ last: p_task->p_dlnk = NULL;
   p_task->delta_time = (U16)(delta - idelay);
   p->delta_time -= p_task->delta_time;
 }
+#endif
 
 
 /*--------------------------- rt_dec_dly ------------------------------------*/
 
+#if OS_DLY_WHEEL
+void rt_dec_dly (void) {
+  /* Release the tasks of the delay wheel due on this tick.                 */
+  P_TCB p_rdy;
+
+  while ((p_rdy = rt_wheel_get (&os_dly_wheel, (U16)os_time)) != NULL) {
+    if (p_rdy->p_rlnk != NULL) {
+      /* Task is really enqueued, remove task from semaphore/mailbox */
+      /* timeout waiting list. */
+      p_rdy->p_rlnk->p_lnk = p_rdy->p_lnk;
+      if (p_rdy->p_lnk != NULL) {
+        p_rdy->p_lnk->p_rlnk = p_rdy->p_rlnk;
+        p_rdy->p_lnk = NULL;
+      }
+      p_rdy->p_rlnk = NULL;
+    }
+    rt_put_prio (&os_rdy, p_rdy);
+    if (p_rdy->state == WAIT_ITV) {
+      /* Calculate the next time for interval wait. */
+      p_rdy->delta_time = p_rdy->interval_time + (U16)os_time;
+    }
+    p_rdy->state   = READY;
+  }
+}
+#else
 void rt_dec_dly (void) {
   /* Decrement delta time of list head: remove tasks having a value of zero.*/
   P_TCB p_rdy;
@@ -242,6 +309,7 @@ void rt_dec_dly (void) {
     p_rdy->p_blnk = NULL;
   }
 }
+#endif
 
 
 /*--------------------------- rt_rmv_list -----------------------------------*/
@@ -265,6 +333,9 @@ void rt_rmv_list (P_TCB p_task) {
     /* Search the ready list for task "p_task" */
     if (p_b->p_lnk == p_task) {
       p_b->p_lnk = p_task->p_lnk;
+#if OS_RDY_BITMAP
+      rt_map_out (&os_rdy, &os_rdy_map, p_b, p_task);
+#endif
       return;
     }
     p_b = p_b->p_lnk;
@@ -274,6 +345,14 @@ void rt_rmv_list (P_TCB p_task) {
 
 /*--------------------------- rt_rmv_dly ------------------------------------*/
 
+#if OS_DLY_WHEEL
+void rt_rmv_dly (P_TCB p_task) {
+  /* Remove task identified with "p_task" from delay wheel if enqueued.     */
+  if (p_task->p_blnk != NULL) {
+    rt_wheel_rmv (&os_dly_wheel, p_task);
+  }
+}
+#else
 void rt_rmv_dly (P_TCB p_task) {
   /* Remove task identified with "p_task" from delay list if enqueued.      */
   P_TCB p_b;
@@ -295,6 +374,22 @@ void rt_rmv_dly (P_TCB p_task) {
     p_task->p_blnk = NULL;
   }
 }
+#endif
+
+
+/*--------------------------- rt_dly_next -----------------------------------*/
+
+U32 rt_dly_next (void) {
+  /* Ticks until the first delayed task is due, 0xFFFF if none.            */
+#if OS_DLY_WHEEL
+  return (rt_wheel_next (&os_dly_wheel, (U16)os_time));
+#else
+  if (os_dly.p_dlnk == NULL) {
+    return (0xFFFF);
+  }
+  return (os_dly.delta_time);
+#endif
+}
 
 
 /*--------------------------- rt_psq_enq ------------------------------------*/
@@ -34,6 +34,18 @@
 
 /* Definitions */
 
+/* Index the ready list by priority (see rt_RdyMap.h); 0 keeps the linear */
+/* walk of the original list. The index needs CLZ (ARMv7-M).              */
+#ifndef OS_RDY_BITMAP
+#define OS_RDY_BITMAP   1
+#endif
+
+/* Keep delayed tasks and user timers in timing wheels (see rt_DlyWheel.h) */
+/* instead of delta sorted chains; 0 keeps the chains.                    */
+#ifndef OS_DLY_WHEEL
+#define OS_DLY_WHEEL    1
+#endif
+
 /* Values for 'cb_type' */
 #define TCB             0
 #define MCB             1
@@ -44,6 +56,12 @@
 /* Variables */
 extern struct OS_XCB os_rdy;
 extern struct OS_XCB os_dly;
+#if OS_RDY_BITMAP
+extern struct OS_RDYMAP os_rdy_map;
+#endif
+#if OS_DLY_WHEEL
+extern struct OS_DLYWHEEL os_dly_wheel;
+#endif
 
 /* Functions */
 extern void  rt_put_prio      (P_XCB p_CB, P_TCB p_task);
@@ -55,6 +73,7 @@ extern void  rt_put_dly       (P_TCB p_task, U16 delay);
 extern void  rt_dec_dly       (void);
 extern void  rt_rmv_list      (P_TCB p_task);
 extern void  rt_rmv_dly       (P_TCB p_task);
+extern U32   rt_dly_next      (void);
 extern void  rt_psq_enq       (OS_ID entry, U32 arg);
 
 /* This is a fast macro generating in-line code */
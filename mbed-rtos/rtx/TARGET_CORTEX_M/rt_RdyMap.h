@@ -0,0 +1,119 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_RDYMAP.H
+ *      Purpose: Priority index of the ready list
+ *----------------------------------------------------------------------------
+ *
+ * The ready list stays one chain of tasks in priority order, FIFO within a
+ * priority, so every reader of 'os_rdy' works unchanged. The index keeps
+ * the last task of every priority level below OS_RDY_LEVELS and a bitmap
+ * of the levels in use: a task is appended behind the tail of its level,
+ * or behind the tail of the nearest level above it, found with CLZ,
+ * instead of walking the chain. Each level is a FIFO list threaded
+ * through the chain; its head is the element after the tail above it.
+ *
+ * Tasks of priority OS_RDY_LEVELS and above (in CMSIS-RTOS only the main
+ * thread at 255 while the kernel is initialized) are not indexed: they
+ * are kept at the head of the chain and inserted by walking it.
+ *
+ * The functions only touch the chain and the index given to them, so the
+ * host build can run them against the linear walk.
+ *---------------------------------------------------------------------------*/
+
+/* Definitions */
+#ifndef RT_CLZ
+#define RT_CLZ(x)       __clz(x)
+#endif
+
+/* Functions */
+
+__inline static P_XCB rt_map_prev (P_XCB p_CB, P_RDYMAP p_map, U32 prio) {
+  /* Element of the chain "p_CB" after which a task of priority "prio" is  */
+  /* appended: the tail of its level, else the tail of the nearest level   */
+  /* above, else the last unindexed task or the list head.                 */
+  U32 above;
+
+  if (p_map->map & (1U << prio)) {
+    return ((P_XCB)p_map->tail[prio]);
+  }
+  above = p_map->map & ~((2U << prio) - 1);
+  if (above) {
+    above &= -above;
+    return ((P_XCB)p_map->tail[31 - RT_CLZ (above)]);
+  }
+  while (p_CB->p_lnk != NULL && p_CB->p_lnk->prio >= OS_RDY_LEVELS) {
+    p_CB = (P_XCB)p_CB->p_lnk;
+  }
+  return (p_CB);
+}
+
+
+__inline static void rt_map_put (P_XCB p_CB, P_RDYMAP p_map, P_TCB p_task) {
+  /* Put task "p_task" at the end of its priority level in chain "p_CB".   */
+  U32 prio;
+
+  prio = p_task->prio;
+  if (prio < OS_RDY_LEVELS) {
+    p_CB = rt_map_prev (p_CB, p_map, prio);
+    p_map->tail[prio] = p_task;
+    p_map->map |= 1U << prio;
+  }
+  else {
+    while (p_CB->p_lnk != NULL && prio <= p_CB->p_lnk->prio) {
+      p_CB = (P_XCB)p_CB->p_lnk;
+    }
+  }
+  p_task->p_lnk = p_CB->p_lnk;
+  p_task->p_rlnk = NULL;
+  p_CB->p_lnk = p_task;
+}
+
+
+__inline static void rt_map_head_in (P_RDYMAP p_map, P_TCB p_task) {
+  /* Task "p_task" was put at the head of the chain.                       */
+  U32 prio;
+
+  prio = p_task->prio;
+  if (prio < OS_RDY_LEVELS && (p_map->map & (1U << prio)) == 0) {
+    p_map->tail[prio] = p_task;
+    p_map->map |= 1U << prio;
+  }
+}
+
+
+__inline static void rt_map_head_out (P_RDYMAP p_map, P_TCB p_first) {
+  /* Task "p_first" was taken from the head of the chain.                  */
+  U32 prio;
+
+  prio = p_first->prio;
+  if (prio < OS_RDY_LEVELS && p_map->tail[prio] == p_first) {
+    p_map->map &= ~(1U << prio);
+  }
+}
+
+
+__inline static void rt_map_out (P_XCB p_CB, P_RDYMAP p_map, P_TCB p_prev,
+                                 P_TCB p_task) {
+  /* Task "p_task" was unlinked from behind "p_prev". Its priority may     */
+  /* have changed already, so its level is found by its tail entry.        */
+  U32 map,prio;
+
+  for (map = p_map->map; map; map &= ~(1U << prio)) {
+    prio = 31 - RT_CLZ (map);
+    if (p_map->tail[prio] == p_task) {
+      if (p_prev != (P_TCB)p_CB && p_prev->prio == prio) {
+        p_map->tail[prio] = p_prev;
+      }
+      else {
+        p_map->map &= ~(1U << prio);
+      }
+      return;
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
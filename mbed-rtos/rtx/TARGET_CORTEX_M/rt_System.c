@@ -73,20 +73,30 @@ __RL_RTX_VER    EQU     0x450
 #endif
 
 
+#ifdef __CMSIS_RTOS
+extern U32  sysUserTimerWakeupTime (void);
+extern void sysUserTimerUpdate (U32 sleep_time);
+extern void sysTimerTick (void);
+#endif
+
 /*--------------------------- rt_suspend ------------------------------------*/
 U32 rt_suspend (void) {
   /* Suspend OS scheduler */
   U32 delta = 0xFFFF;
+#ifdef __CMSIS_RTOS
+  U32 sleep;
+#endif
 
   rt_tsk_lock();
 
-  if (os_dly.p_dlnk) {
-    delta = os_dly.delta_time;
-  }
+  delta = rt_dly_next ();
 #ifndef __CMSIS_RTOS
   if (os_tmr.next) {
     if (os_tmr.tcnt < delta) delta = os_tmr.tcnt;
   }
+#else
+  sleep = sysUserTimerWakeupTime();
+  if (sleep < delta) delta = sleep;
 #endif
 
   return (delta);
@@ -98,6 +108,12 @@ void rt_resume (U32 sleep_time) {
   /* Resume OS scheduler after suspend */
   P_TCB next;
   U32   delta;
+#if OS_DLY_WHEEL
+  U32   left;
+#ifdef __CMSIS_RTOS
+  U32   wake;
+#endif
+#endif
 
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
@@ -105,6 +121,27 @@ void rt_resume (U32 sleep_time) {
   os_robin.task = NULL;
 
   /* Update delays. */
+#if OS_DLY_WHEEL
+  /* Step to each tick something is due on, in order. */
+  left = sleep_time;
+  while (left) {
+    delta = rt_dly_next ();
+#ifdef __CMSIS_RTOS
+    wake = sysUserTimerWakeupTime ();
+    if (wake < delta) delta = wake;
+#endif
+    if (delta > left) {
+      os_time += left;
+      break;
+    }
+    os_time += delta;
+    left    -= delta;
+    rt_dec_dly ();
+#ifdef __CMSIS_RTOS
+    sysTimerTick ();
+#endif
+  }
+#else
   if (os_dly.p_dlnk) {
     delta = sleep_time;
     if (delta >= os_dly.delta_time) {
@@ -124,8 +161,14 @@ void rt_resume (U32 sleep_time) {
   } else {
     os_time += sleep_time;
   }
+#endif
 
-#ifndef __CMSIS_RTOS
+#ifdef __CMSIS_RTOS
+#if !OS_DLY_WHEEL
+  /* Check the user timers. */
+  sysUserTimerUpdate(sleep_time);
+#endif
+#else
   /* Check the user timers. */
   if (os_tmr.next) {
     delta = sleep_time;
@@ -151,6 +194,14 @@ void rt_resume (U32 sleep_time) {
 }
 
 
+/*--------------------------- rt_lock_pending -------------------------------*/
+
+U32 rt_lock_pending (void) {
+  /* Check for a tick or an ISR request held back by the scheduler lock. */
+  return (pend_flags | os_psh_flag);
+}
+
+
 /*--------------------------- rt_tsk_lock -----------------------------------*/
 
 void rt_tsk_lock (void) {
@@ -252,8 +303,6 @@ __weak void os_tick_irqack (void) {
 
 /*--------------------------- rt_systick ------------------------------------*/
 
-extern void sysTimerTick(void);
-
 void rt_systick (void) {
   /* Check for system clock update, suspend running task. */
   P_TCB next;
@@ -102,6 +102,21 @@ void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
 }
 
 
+/*--------------------------- rt_stk_fill -----------------------------------*/
+
+void rt_stk_fill (U32 *stk, U32 size) {
+  /* Fill a stack of "size" bytes with MAGIC_WORD, before its context is    */
+  /* initialized. The words never written stay as they are, so the deepest */
+  /* use of the stack is where the fill ends (osThreadStackMax). mbed      */
+  /* Thread objects fill their own stacks, this is for the system threads. */
+  U32 i;
+
+  for (i = 0; i < (size >> 2); i++) {
+    stk[i] = MAGIC_WORD;
+  }
+}
+
+
 /*--------------------------- rt_switch_req ---------------------------------*/
 
 void rt_switch_req (P_TCB p_new) {
@@ -278,16 +293,26 @@ void rt_sys_init (FUNCP first_task, U32 prio_stksz, void *stk) {
   os_idle_TCB.task_id = 255;
   os_idle_TCB.priv_stack = idle_task_stack_size;
   os_idle_TCB.stack = idle_task_stack;
+  rt_stk_fill (idle_task_stack, idle_task_stack_size);
   rt_init_context (&os_idle_TCB, 0, os_idle_demon);
 
   /* Set up ready list: initially empty */
   os_rdy.cb_type = HCB;
   os_rdy.p_lnk   = NULL;
+#if OS_RDY_BITMAP
+  os_rdy_map.map = 0;
+#endif
   /* Set up delay list: initially empty */
   os_dly.cb_type = HCB;
   os_dly.p_dlnk  = NULL;
   os_dly.p_blnk  = NULL;
   os_dly.delta_time = 0;
+#if OS_DLY_WHEEL
+  for (i = 0; i < OS_DLY_SLOTS; i++) {
+    os_dly_wheel.slot[i] = NULL;
+  }
+  os_dly_wheel.count = 0;
+#endif
 
   /* Fix SP and systemvariables to assume idle task is running  */
   /* Transform main program into idle task by assuming idle TCB */
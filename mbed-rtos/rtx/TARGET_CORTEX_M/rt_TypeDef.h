@@ -76,6 +76,13 @@ typedef struct OS_XCB {
   U16    delta_time;              /* Time until time out                     */
 } *P_XCB;
 
+#define OS_RDY_LEVELS   32        /* Priorities indexed in the ready list    */
+
+typedef struct OS_RDYMAP {        /* Ready list priority index               */
+  U32    map;                     /* Bit n set: level n has ready tasks      */
+  struct OS_TCB *tail[OS_RDY_LEVELS]; /* Last ready task of each level       */
+} *P_RDYMAP;
+
 typedef struct OS_MCB {
   U8     cb_type;                 /* Control Block Type                      */
   U8     state;                   /* State flag variable                     */
@@ -114,6 +121,18 @@ typedef struct OS_TMR {
   U16    info;                    /* User defined call info                  */
 } *P_TMR;
 
+#define OS_DLY_SLOTS    32        /* Slots of a timing wheel, power of 2     */
+
+typedef struct OS_DLYWHEEL {      /* Delay timing wheel                      */
+  struct OS_TCB *slot[OS_DLY_SLOTS]; /* Tasks due on a tick, by tick        */
+  U16    count;                   /* Tasks in the wheel                      */
+} *P_DLYWHEEL;
+
+typedef struct OS_TMRWHEEL {      /* User timer timing wheel                 */
+  struct OS_TMR *slot[OS_DLY_SLOTS]; /* Timers due on a tick, by tick       */
+  U16    count;                   /* Timers in the wheel                     */
+} *P_TMRWHEEL;
+
 typedef struct OS_BM {
   void *free;                     /* Pointer to first free memory block      */
   void *end;                      /* Pointer to memory block end             */
@@ -8,15 +8,20 @@
 //          -speed      (uint8_t)
 //          -accelerator(uint8_t)
 //          -brake      (uint8_t)
+//          -time       (uint32_t, ms when the record was sampled)
 //
 //************************************************************************
 #ifndef __MESSAGE_H__
 #define __MESSAGE_H__
 
+/* Standard includes */
+#include <stdint.h>
+
 typedef struct {
   char  speed;
   char  accelerator;
   char  brake;
+  uint32_t time;
 } message;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+//************************************************************************
+//
+//  pedalbench.cpp
+//
+//  Pedal scaling benchmark
+//
+//************************************************************************
+
+/* Header includes */
+#include "pedalbench.h"
+
+/* Scaling includes */
+#include "pedals.h"
+
+/* Cycle counter includes */
+#include "cycles.h"
+
+/* Results are summed here so no path is optimised away */
+static volatile uint32_t sink;
+
+/*  Former path */
+//  @brief  as updateAcceleration/updateBrake used to be: float scaling,
+//          each AnalogIn copied on the call
+static char scaleFloat(AnalogIn pin)
+{
+    float reading = (pin.read() * 255);
+    char value = reading;
+    return value;
+}
+
+/*  Integer path */
+//  @brief  12-bit code back from the 16-bit conversion, then pedalScale
+static char scaleInteger(AnalogIn &pin)
+{
+    return pedalScale(pin.read_u16() >> 4);
+}
+
+/*  Times both scaling paths */
+void benchmarkPedals(AnalogIn &accelerator, AnalogIn &brake, uint32_t ticks,
+                     PedalBenchmark &result)
+{
+    result.ticks = ticks;
+    result.float_total = 0;
+    result.integer_total = 0;
+    result.float_min = 0xFFFFFFFF;
+    result.integer_min = 0xFFFFFFFF;
+    result.mismatches = 0;
+
+    cyclesInit();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        uint32_t start = cyclesRead();
+        char acc_f = scaleFloat(accelerator);
+        char brake_f = scaleFloat(brake);
+        uint32_t middle = cyclesRead();
+        char acc_i = scaleInteger(accelerator);
+        char brake_i = scaleInteger(brake);
+        uint32_t end = cyclesRead();
+
+        uint32_t spent_float = middle - start;
+        uint32_t spent_integer = end - middle;
+        result.float_total += spent_float;
+        result.integer_total += spent_integer;
+        if (spent_float < result.float_min)
+            result.float_min = spent_float;
+        if (spent_integer < result.integer_min)
+            result.integer_min = spent_integer;
+
+        if (acc_f != acc_i || brake_f != brake_i)
+            result.mismatches++;
+        sink += acc_f + brake_f + acc_i + brake_i;
+    }
+}
+
+/*  Compares both scaling paths over every ADC code */
+//  @brief  feeds all 4096 conversion results through the LPC1768 HAL
+//          scaling of read() and read_u16(), then through each path
+void sweepPedalCodes(PedalSweep &result)
+{
+    result.codes = 4096;
+    result.mismatches = 0;
+    result.integer_higher = 0;
+    result.max_difference = 0;
+
+    for (uint32_t code = 0; code < 4096; code++)
+    {
+        // analogin_read and analogin_read_u16 of the LPC176X HAL
+        float reading = (float)code * (1.0f / (float)0xFFF);
+        unsigned short wide = (code << 4) | ((code >> 8) & 0x000F);
+
+        char value_f = (char)(reading * 255);
+        char value_i = pedalScale(wide >> 4);
+        if (value_f == value_i)
+            continue;
+        uint32_t difference = value_i > value_f ? value_i - value_f : value_f - value_i;
+        result.mismatches++;
+        if (value_i > value_f)
+            result.integer_higher++;
+        if (difference > result.max_difference)
+            result.max_difference = difference;
+    }
+}
@@ -0,0 +1,71 @@
+//************************************************************************
+//
+//  pedalbench.h
+//
+//  Requirements: mbed.h, cycles.h
+//
+//  Benchmark of one updateCommands tick worth of pedal scaling: both
+//  pedals read and scaled to 0 - 255, once through the former float
+//  path (AnalogIn::read() * 255, pins passed by value) and once through
+//  the integer path (pedalScale of AnalogIn::read_u16() >> 4, pins by
+//  reference).
+//
+//  The LPC1768 HAL returns read() as code / 4095 and read_u16() as the
+//  12-bit code widened to (code << 4) | (code >> 8), so read_u16() >> 4
+//  gives the code back, and the float path truncates code * 255 / 4095.
+//  The top byte of read_u16() alone would be code >> 4, one count higher
+//  on 2040 of the 4096 codes; pedalScale computes the division exactly.
+//  The code sweep checks every code, without the ADC.
+//
+//  Build flag:
+//          -PEDAL_BENCHMARK    1 makes main() run the benchmark and print
+//                              it on the USB serial port before starting
+//                              the Controller (default 0)
+//
+//  Functions:
+//          -benchmarkPedals    times the given number of ticks per path
+//          -sweepPedalCodes    compares both paths over every 12-bit code
+//
+//************************************************************************
+#ifndef __PEDALBENCH_H__
+#define __PEDALBENCH_H__
+
+/* Mbed includes */
+#include "mbed.h"
+
+#ifndef PEDAL_BENCHMARK
+#define PEDAL_BENCHMARK     0
+#endif
+
+/* Benchmark results, counts in CYCLES_UNIT */
+typedef struct {
+    uint32_t ticks;
+    uint32_t float_total;
+    uint32_t integer_total;
+    uint32_t float_min;
+    uint32_t integer_min;
+    uint32_t mismatches;
+} PedalBenchmark;
+
+/* Code sweep results */
+typedef struct {
+    uint32_t codes;
+    uint32_t mismatches;        // codes where the paths differ
+    uint32_t integer_higher;    // of which the integer path is higher
+    uint32_t max_difference;    // in counts
+} PedalSweep;
+
+/*  Times both scaling paths */
+//  @param  accelerator, brake  pedal inputs
+//  @param  ticks               updateCommands ticks per path
+//  @param  result              totals and best tick of each path, and
+//                              how many ticks the two paths disagreed
+void benchmarkPedals(AnalogIn &accelerator, AnalogIn &brake, uint32_t ticks,
+                     PedalBenchmark &result);
+
+/*  Compares both scaling paths over every ADC code */
+//  @param  result              codes where the paths differ, through the
+//                              LPC1768 read() and read_u16() expansions
+void sweepPedalCodes(PedalSweep &result);
+
+#endif
@@ -0,0 +1,133 @@
+//************************************************************************
+//
+//  pedals.cpp
+//
+//  PedalFilter and PedalSampler Classes
+//
+//************************************************************************
+
+/* Header includes */
+#include "pedals.h"
+
+/* LPC1768 ADC control */
+#define ADC_SEL_MASK        0xFF
+#define ADC_BURST           (1 << 16)
+#define ADC_START_MASK      (7 << 24)
+#define ADC_GLOBAL_INT      (1 << 8)
+
+/*  Default Constructor */
+PedalFilter::PedalFilter()
+: sum(0),
+  count(0),
+  state(0),
+  output(0)
+{
+}
+
+/*  Starts the filter at a level */
+//  @brief  skips the IIR rise time after power up
+void PedalFilter::reset(uint32_t raw)
+{
+    sum = 0;
+    count = 0;
+    state = raw << 8;
+    uint32_t out = ((uint32_t)state * 255 + (1 << 19)) >> 20;
+    output = out > 255 ? 255 : out;
+}
+
+/*  Default Constructor */
+//  @param  accelerator, brake  analog pins of the pedals
+//
+//  @brief  The AnalogIn members route the pins and power the ADC; on
+//          the LPC1768 the converter is then switched to burst mode
+//          over both channels, and the ticker starts sampling
+PedalSampler::PedalSampler(PinName accelerator, PinName brake)
+: accelerator_in(accelerator),
+  brake_in(brake),
+  accelerator_channel(channelOf(accelerator)),
+  brake_channel(channelOf(brake)),
+  samples(0)
+{
+    accelerator_filter.reset(convert(accelerator_in, -1));
+    brake_filter.reset(convert(brake_in, -1));
+
+#if defined(TARGET_LPC1768)
+    if (accelerator_channel >= 0 && brake_channel >= 0)
+    {
+        LPC_ADC->ADINTEN &= ~ADC_GLOBAL_INT;
+        LPC_ADC->ADCR = (LPC_ADC->ADCR & ~(ADC_SEL_MASK | ADC_START_MASK))
+                        | (1 << accelerator_channel) | (1 << brake_channel)
+                        | ADC_BURST;
+    }
+    else
+#endif
+    {
+        accelerator_channel = -1;
+        brake_channel = -1;
+    }
+
+    ticker.attach_us(this, &PedalSampler::tick, 1000000 / PEDAL_SAMPLE_HZ);
+}
+
+/*  Standard Accessor */
+//  @return filtered accelerator, 0 - 255
+uint8_t PedalSampler::getAccelerator()
+{
+    return accelerator_filter.value();
+}
+
+/*  Standard Accessor */
+//  @return filtered brake, 0 - 255
+uint8_t PedalSampler::getBrake()
+{
+    return brake_filter.value();
+}
+
+/*  Standard Accessor */
+//  @return ticker samples taken, per channel
+uint32_t PedalSampler::getSamples()
+{
+    return samples;
+}
+
+/*  Ticker interrupt */
+//  @rate   PEDAL_SAMPLE_HZ
+void PedalSampler::tick()
+{
+    accelerator_filter.sample(convert(accelerator_in, accelerator_channel));
+    brake_filter.sample(convert(brake_in, brake_channel));
+    samples++;
+}
+
+/*  Latest conversion of a channel */
+//  @param  pin         fallback input
+//  @param  channel     burst mode channel, -1 for a single conversion
+//  @return 12-bit result
+//
+//  N.B.: in burst mode the data register always holds a result less
+//        than a conversion time old, reading it does not wait
+uint32_t PedalSampler::convert(AnalogIn &pin, int channel)
+{
+#if defined(TARGET_LPC1768)
+    if (channel >= 0)
+        return ((&LPC_ADC->ADDR0)[channel] >> 4) & 0xFFF;
+#endif
+    (void)channel;
+    return pin.read_u16() >> 4;
+}
+
+/*  ADC channel of a pin */
+//  @return AD0 channel, -1 if the pin has none
+int PedalSampler::channelOf(PinName pin)
+{
+    switch (pin)
+    {
+        case p15: return 0;
+        case p16: return 1;
+        case p17: return 2;
+        case p18: return 3;
+        case p19: return 4;
+        case p20: return 5;
+        default:  return -1;
+    }
+}
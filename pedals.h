@@ -0,0 +1,134 @@
+//************************************************************************
+//
+//  pedals.h
+//
+//  Requirements: mbed.h
+//
+//  Defines the PedalFilter and PedalSampler Classes: oversampled,
+//  filtered acquisition of the accelerator and brake pedals.
+//
+//  A Ticker samples both channels at PEDAL_SAMPLE_HZ. On the LPC1768 the
+//  ADC runs in hardware burst mode over the two channels, so the ticker
+//  only collects the latest results from the data registers and never
+//  waits on a conversion; elsewhere it falls back to AnalogIn::read_u16.
+//
+//  Each channel is decimated by PEDAL_DECIMATION (boxcar average, exact
+//  with a power of two) then smoothed by a single pole IIR filter,
+//  y += (x - y) / 2^PEDAL_IIR_SHIFT, in integer arithmetic. The result
+//  is published as an 8-bit value, a single byte store, so readers need
+//  no lock.
+//
+//  Build flag:
+//          -PEDAL_OVERSAMPLING     1 (default) the Controller reads the
+//                                  pedals from a PedalSampler, 0 it takes
+//                                  a single conversion per update
+//
+//  Methods:
+//          -pedalScale         12-bit code to 0 - 255, single conversion
+//          -getAccelerator     latest filtered accelerator, 0 - 255
+//          -getBrake           latest filtered brake, 0 - 255
+//          -getSamples         ticker samples taken
+//
+//************************************************************************
+#ifndef __PEDALS_H__
+#define __PEDALS_H__
+
+/* Mbed includes */
+#include "mbed.h"
+
+#ifndef PEDAL_OVERSAMPLING
+#define PEDAL_OVERSAMPLING  1
+#endif
+
+/* Raw sampling rate of each channel */
+#define PEDAL_SAMPLE_HZ     1600
+
+/* Raw samples per filtered sample, power of two */
+#define PEDAL_DECIMATION    16
+
+/* IIR time constant, in filtered samples: 2^PEDAL_IIR_SHIFT */
+#define PEDAL_IIR_SHIFT     2
+
+/*  Scales a single conversion */
+//  @param  code    12-bit conversion result
+//  @return code * 255 / 4095, truncated like the former read() * 255
+//
+//  N.B.: 4081 / 2^16 gives the same value as the division for every
+//        12-bit code (pedalbench.h sweeps them), with no divide
+inline char pedalScale(uint32_t code)
+{
+    return (code * 4081) >> 16;
+}
+
+class PedalFilter
+{
+    public:
+        /* Default Constructor */
+        PedalFilter();
+
+        /*  Adds a raw sample */
+        //  @param  raw     12-bit conversion result
+        //  @return true when a decimated sample updated the output
+        bool sample(uint32_t raw)
+        {
+            sum += raw;
+            if (++count < PEDAL_DECIMATION)
+                return false;
+
+            // Boxcar mean in Q8, then one IIR step
+            int32_t x = (int32_t)(sum << 8) / PEDAL_DECIMATION;
+            sum = 0;
+            count = 0;
+            state += (x - state) >> PEDAL_IIR_SHIFT;
+
+            // Q8 12-bit to 8-bit, rounded
+            uint32_t out = ((uint32_t)state * 255 + (1 << 19)) >> 20;
+            output = out > 255 ? 255 : out;
+            return true;
+        }
+
+        /*  Starts the filter at a level */
+        //  @param  raw     12-bit conversion result
+        void reset(uint32_t raw);
+
+        /*  Standard Accessor */
+        uint8_t value() const { return output; }
+
+    private:
+        uint32_t sum;
+        uint32_t count;
+        int32_t state;
+        volatile uint8_t output;
+};
+
+class PedalSampler
+{
+    public:
+        /* Default Constructor */
+        PedalSampler(PinName accelerator, PinName brake);
+
+        /* Filtered pedals, lock-free */
+        uint8_t getAccelerator();
+        uint8_t getBrake();
+
+        /* Statistics */
+        uint32_t getSamples();
+
+    private:
+        void tick();
+        uint32_t convert(AnalogIn &pin, int channel);
+        static int channelOf(PinName pin);
+
+    protected:
+        /* Members */
+        AnalogIn accelerator_in;
+        AnalogIn brake_in;
+        int accelerator_channel;
+        int brake_channel;
+        PedalFilter accelerator_filter;
+        PedalFilter brake_filter;
+        volatile uint32_t samples;
+        Ticker ticker;
+};
+
+#endif
@@ -0,0 +1,94 @@
+//************************************************************************
+//
+//  physics.h
+//
+//  Fixed-point integrator shared by the Car simulator.
+//
+//  Speed is kept in signed Qm.PHYSICS_FRAC_BITS, distance as whole
+//  metres plus a PHYSICS_FRAC_BITS fraction, so sub-unit increments
+//  accumulate across ticks instead of being truncated away. Only
+//  integer adds, shifts and one 32x32->64 multiply per step: no
+//  soft-float calls on the Cortex-M3.
+//
+//  Build flags:
+//          -PHYSICS_FRAC_BITS      fractional bits, 8 to 22 (default 16)
+//
+//************************************************************************
+#ifndef __PHYSICS_H__
+#define __PHYSICS_H__
+
+/* Standard includes */
+#include <stdint.h>
+
+#ifndef PHYSICS_FRAC_BITS
+#define PHYSICS_FRAC_BITS   16
+#endif
+
+#if PHYSICS_FRAC_BITS < 8 || PHYSICS_FRAC_BITS > 22
+#error "PHYSICS_FRAC_BITS must be between 8 and 22"
+#endif
+
+/* 1.0 in Q format */
+#define PHYSICS_ONE         ((int32_t)1 << PHYSICS_FRAC_BITS)
+
+/* Mask of the fractional part */
+#define PHYSICS_FRAC_MASK   ((uint32_t)PHYSICS_ONE - 1)
+
+/* Top speed, 255 in Q format */
+#define PHYSICS_MAX_SPEED   ((int32_t)255 << PHYSICS_FRAC_BITS)
+
+/* 20Hz time step, 0.05s in Q format (rounded) */
+#define PHYSICS_DT          ((PHYSICS_ONE + 10) / 20)
+
+/*  Time step conversion */
+//  @param  us      time step in microseconds
+//  @return time step in seconds, Q format
+inline int32_t physicsTimeStep(uint32_t us)
+{
+    return (int32_t)((((uint64_t)us << PHYSICS_FRAC_BITS) + 500000) / 1000000);
+}
+
+/*  Speed integration */
+//  @param  speed   current speed, Q format
+//  @param  acc     accelerator value 0-255
+//  @param  brake   brake value 0-255
+//  @param  dt      time step, Q format
+//  @return new speed clamped to 0-255, Q format
+inline int32_t physicsSpeed(int32_t speed, int acc, int brake, int32_t dt)
+{
+    speed += (acc - brake) * dt;
+    if (speed < 0)
+        return 0;
+    if (speed > PHYSICS_MAX_SPEED)
+        return PHYSICS_MAX_SPEED;
+    return speed;
+}
+
+/*  Distance integration */
+//  @param  metres  whole metres, updated in place
+//  @param  frac    fractional metres (PHYSICS_FRAC_BITS), updated in place
+//  @param  speed   current speed, Q format, never negative
+//  @param  dt      time step, Q format
+inline void physicsDistance(uint32_t &metres, uint32_t &frac, int32_t speed, int32_t dt)
+{
+    frac += (uint32_t)(((uint64_t)(uint32_t)speed * (uint32_t)dt) >> PHYSICS_FRAC_BITS);
+    metres += frac >> PHYSICS_FRAC_BITS;
+    frac &= PHYSICS_FRAC_MASK;
+}
+
+/*  Distance integration, 32-bit only */
+//  @brief  same result as physicsDistance, splitting the speed in its
+//          integer and fractional parts so no 64-bit product is needed
+//          (lets array loops vectorize)
+//
+//  N.B.:Exact only for PHYSICS_FRAC_BITS <= 16 and dt < PHYSICS_ONE
+inline void physicsDistance32(uint32_t &metres, uint32_t &frac, int32_t speed, int32_t dt)
+{
+    uint32_t whole = (uint32_t)speed >> PHYSICS_FRAC_BITS;
+    uint32_t part = (uint32_t)speed & PHYSICS_FRAC_MASK;
+    frac += whole * (uint32_t)dt + ((part * (uint32_t)dt) >> PHYSICS_FRAC_BITS);
+    metres += frac >> PHYSICS_FRAC_BITS;
+    frac &= PHYSICS_FRAC_MASK;
+}
+
+#endif
@@ -21,15 +21,17 @@ DigitalOut left_led(LED3);
 DigitalOut right_led(LED4);
 DigitalOut warning(p11);
 
-/* Digital Inputs */
-DigitalIn engine_sw(p5);
-DigitalIn sidelight_sw(p6);
-DigitalIn left_sw(p7);
-DigitalIn right_sw(p8);
+/* Switch Inputs, edge interrupts (see switches.h) */
+InterruptIn engine_sw(p5);
+InterruptIn sidelight_sw(p6);
+InterruptIn left_sw(p7);
+InterruptIn right_sw(p8);
 
 /* Analog Inputs */
-AnalogIn  accelerator_pedal(p17);
-AnalogIn  brake_pedal(p16);  
+#define ACCELERATOR_PIN     p17
+#define BRAKE_PIN           p16
+AnalogIn  accelerator_pedal(ACCELERATOR_PIN);
+AnalogIn  brake_pedal(BRAKE_PIN);  
 
 /* Servo motors */
 Servo motor(p21);
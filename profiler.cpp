@@ -0,0 +1,130 @@
+//************************************************************************
+//
+//  profiler.cpp
+//
+//  Profiler Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "profiler.h"
+
+/* Formatting includes */
+#include "format.h"
+
+/* Standard includes */
+#include <string.h>
+
+/* Column widths of a dumped line */
+#define NAME_WIDTH      12
+
+/*  Default Constructor */
+Profiler::Profiler()
+: count(0)
+{
+    cyclesInit();
+}
+
+/*  Adds an entry */
+//  @param  name        task name used in reports, not copied
+//  @param  period_us   nominal period, 0 for event driven tasks
+//  @return entry id, -1 if the table is full
+int Profiler::add(const char *name, uint32_t period_us)
+{
+    if (count == PROFILER_MAX_ENTRIES)
+        return -1;
+
+    ProfileEntry &e = entries[count];
+    e.name = name;
+    e.period_us = period_us;
+    e.runs = 0;
+    e.min_cycles = 0xFFFFFFFF;
+    e.max_cycles = 0;
+    e.total_cycles = 0;
+    e.max_jitter_us = 0;
+    e.total_jitter_us = 0;
+    e.jitter_samples = 0;
+    e.start_cycles = 0;
+    e.last_start_us = 0;
+    return count++;
+}
+
+/*  Standard Accessor */
+int Profiler::getCount()
+{
+    return count;
+}
+
+/*  Standard Accessor */
+const ProfileEntry &Profiler::entry(int id)
+{
+    return entries[id];
+}
+
+/*  Column titles */
+//  @param  line    at least PROFILER_LINE characters
+//  @return characters written, terminated by CR LF
+//
+//  N.B.: execution times are in CYCLES_UNIT, jitter in microseconds
+int Profiler::header(char *line)
+{
+    static const char titles[] =
+        "task              runs       min       max      mean   jitter max      mean"
+        "  (" CYCLES_UNIT ", us)\r\n";
+    memcpy(line, titles, sizeof(titles) - 1);
+    return sizeof(titles) - 1;
+}
+
+/*  Formats an entry */
+//  @param  id      entry to format
+//  @param  line    at least PROFILER_LINE characters
+//  @return characters written, terminated by CR LF
+//
+//  N.B.: no printf, safe to call from the executive thread
+int Profiler::format(int id, char *line)
+{
+    const ProfileEntry &e = entries[id];
+    uint32_t runs = e.runs;
+    uint32_t mean = runs ? (uint32_t)(e.total_cycles / runs) : 0;
+    uint32_t jitter = e.jitter_samples ? (uint32_t)(e.total_jitter_us / e.jitter_samples) : 0;
+
+    int pos = strlen(e.name);
+    if (pos > NAME_WIDTH)
+        pos = NAME_WIDTH;
+    memcpy(line, e.name, pos);
+    while (pos <= NAME_WIDTH)
+        line[pos++] = ' ';
+    pos += FixedField<9, ' '>::format(line + pos, runs);
+    line[pos++] = ' ';
+    pos += FixedField<9, ' '>::format(line + pos, runs ? e.min_cycles : 0u);
+    line[pos++] = ' ';
+    pos += FixedField<9, ' '>::format(line + pos, e.max_cycles);
+    line[pos++] = ' ';
+    pos += FixedField<9, ' '>::format(line + pos, mean);
+    line[pos++] = ' ';
+    line[pos++] = ' ';
+    line[pos++] = ' ';
+    pos += FixedField<9, ' '>::format(line + pos, e.max_jitter_us);
+    line[pos++] = ' ';
+    pos += FixedField<9, ' '>::format(line + pos, jitter);
+    line[pos++] = '\r';
+    line[pos++] = '\n';
+    return pos;
+}
+
+/*  Clears the statistics */
+//  @brief  keeps the table, restarts every measurement
+void Profiler::reset()
+{
+    for (int i = 0; i < count; i++)
+    {
+        ProfileEntry &e = entries[i];
+        e.runs = 0;
+        e.min_cycles = 0xFFFFFFFF;
+        e.max_cycles = 0;
+        e.total_cycles = 0;
+        e.max_jitter_us = 0;
+        e.total_jitter_us = 0;
+        e.jitter_samples = 0;
+    }
+}
@@ -0,0 +1,116 @@
+//************************************************************************
+//
+//  profiler.h
+//
+//  Requirements: mbed.h, cycles.h, format.h
+//
+//  Defines a Profiler Class: a fixed-size table of execution time and
+//  period jitter statistics, one entry per instrumented task.
+//
+//  Execution time is measured with the cycle counter of cycles.h (DWT
+//  CYCCNT on the LPC1768, std::chrono on the host), so it resolves
+//  single cycles but includes any interrupt that ran in between.
+//  Jitter is the distance between two successive begin() calls and the
+//  nominal period, measured on the microsecond ticker, for entries that
+//  have a period.
+//
+//  Every entry is written by one context only (the thread or interrupt
+//  running the task), so begin()/end() take no lock.
+//
+//  Methods:
+//          -add            registers an entry, returns its id
+//          -begin, end     bracket one run of a task
+//          -format         one text line per entry, for serial dumps
+//
+//************************************************************************
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+/* Mbed includes */
+#include "mbed.h"
+
+/* Cycle counter includes */
+#include "cycles.h"
+
+/* Maximum number of entries in the table */
+#define PROFILER_MAX_ENTRIES    24
+
+/* Longest line written by format(), terminator included */
+#define PROFILER_LINE           96
+
+/* Per entry statistics */
+typedef struct {
+    const char *name;
+    uint32_t period_us;         // 0 for event driven tasks
+    uint32_t runs;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t max_jitter_us;
+    uint64_t total_jitter_us;
+    uint32_t jitter_samples;
+    uint32_t start_cycles;
+    uint32_t last_start_us;
+} ProfileEntry;
+
+class Profiler
+{
+    public:
+        /* Default Constructor */
+        Profiler();
+
+        /* Table setup */
+        int add(const char *name, uint32_t period_us = 0);
+
+        /*  Starts a run */
+        //  @param  id      entry from add(), negative ids are ignored
+        void begin(int id)
+        {
+            if (id < 0)
+                return;
+            ProfileEntry &e = entries[id];
+            uint32_t now = us_ticker_read();
+            if (e.period_us && e.runs)
+            {
+                uint32_t interval = now - e.last_start_us;
+                uint32_t jitter = interval > e.period_us ? interval - e.period_us
+                                                         : e.period_us - interval;
+                e.total_jitter_us += jitter;
+                e.jitter_samples++;
+                if (jitter > e.max_jitter_us)
+                    e.max_jitter_us = jitter;
+            }
+            e.last_start_us = now;
+            e.start_cycles = cyclesRead();
+        }
+
+        /*  Ends a run */
+        //  @param  id      entry given to begin()
+        void end(int id)
+        {
+            if (id < 0)
+                return;
+            ProfileEntry &e = entries[id];
+            uint32_t cycles = cyclesRead() - e.start_cycles;
+            e.runs++;
+            e.total_cycles += cycles;
+            if (cycles < e.min_cycles)
+                e.min_cycles = cycles;
+            if (cycles > e.max_cycles)
+                e.max_cycles = cycles;
+        }
+
+        /* Report */
+        int getCount();
+        const ProfileEntry &entry(int id);
+        int header(char *line);
+        int format(int id, char *line);
+        void reset();
+
+    protected:
+        /* Members */
+        ProfileEntry entries[PROFILER_MAX_ENTRIES];
+        int count;
+};
+
+#endif
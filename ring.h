@@ -0,0 +1,182 @@
+//************************************************************************
+//
+//  ring.h
+//
+//  Defines a TelemetryRing Class template: a wait-free single-producer,
+//  single-consumer ring of N items (N a power of two).
+//
+//  Built on the same idea as mbed::CircularBuffer, but the head is only
+//  written by the producer and the tail only by the consumer, both as
+//  free-running counters, so neither side takes a lock or waits on the
+//  other. A memory barrier orders the item copy against the counter
+//  update; no other synchronization is needed for one producer and one
+//  consumer, whatever their priorities.
+//
+//  When the ring is full the policy decides what is lost:
+//          -RING_DROP_NEWEST       put fails, the ring keeps the oldest
+//          -RING_OVERWRITE_OLDEST  put always succeeds, the consumer
+//                                  skips the items overwritten under it
+//                                  and gets at most the newest N-1
+//
+//  Methods:
+//          -put            producer side, never blocks
+//          -get            consumer side, never blocks
+//          -getDropped     items lost to the policy
+//          -getHighWater   largest number of items ever queued
+//
+//************************************************************************
+#ifndef __RING_H__
+#define __RING_H__
+
+/* Standard includes */
+#include <stdint.h>
+
+/* Orders memory accesses between producer and consumer */
+#if defined(__CC_ARM)
+#define RING_BARRIER()      __dmb(0xF)
+#else
+#define RING_BARRIER()      __sync_synchronize()
+#endif
+
+/* Full ring policies */
+typedef enum {
+    RING_DROP_NEWEST,
+    RING_OVERWRITE_OLDEST
+} RingPolicy;
+
+template<typename T, uint32_t N>
+class TelemetryRing
+{
+    /* Free-running counters wrap correctly only for a power of two */
+    typedef char size_must_be_power_of_two[(N & (N - 1)) == 0 && N > 0 ? 1 : -1];
+
+    public:
+        /* Default Constructor */
+        TelemetryRing(RingPolicy policy = RING_DROP_NEWEST)
+        : policy(policy),
+          head(0),
+          rejected(0),
+          high_water(0),
+          tail(0),
+          overwritten(0)
+        {
+        }
+
+        /*  Producer side */
+        //  @param  item    copied into the ring
+        //  @return false if the item was dropped (RING_DROP_NEWEST only)
+        bool put(const T &item)
+        {
+            uint32_t h = head;
+            uint32_t used = h - tail;
+
+            if (used >= N && policy == RING_DROP_NEWEST)
+            {
+                rejected++;
+                return false;
+            }
+
+            pool[h % N] = item;
+            RING_BARRIER();
+            head = h + 1;
+
+            used = used < N ? used + 1 : N;
+            if (used > high_water)
+                high_water = used;
+            return true;
+        }
+
+        /*  Consumer side */
+        //  @param  item    receives the oldest item
+        //  @return false if the ring is empty
+        bool get(T &item)
+        {
+            uint32_t t = tail;
+
+            while (1)
+            {
+                uint32_t h = head;
+                RING_BARRIER();
+
+                if (h == t)
+                    return false;
+
+                // The producer lapped us: skip what it overwrote, and
+                // the slot it may be rewriting right now
+                if (policy == RING_OVERWRITE_OLDEST && h - t >= N)
+                {
+                    overwritten += h - t - N + 1;
+                    t = h - N + 1;
+                }
+
+                item = pool[t % N];
+                RING_BARRIER();
+
+                // In overwrite mode the slot may have been rewritten
+                // while it was copied, then it counts as overwritten
+                if (policy == RING_OVERWRITE_OLDEST && head - t >= N)
+                {
+                    overwritten++;
+                    t++;
+                    continue;
+                }
+
+                tail = t + 1;
+                return true;
+            }
+        }
+
+        /*  Standard Accessor */
+        //  @return items currently queued
+        uint32_t size()
+        {
+            uint32_t used = head - tail;
+            return used < N ? used : N;
+        }
+
+        /*  Standard Accessor */
+        uint32_t capacity()
+        {
+            return N;
+        }
+
+        /*  Standard Accessor */
+        //  @return items rejected by put plus items overwritten
+        uint32_t getDropped()
+        {
+            return rejected + overwritten;
+        }
+
+        /*  Standard Accessor */
+        uint32_t getHighWater()
+        {
+            return high_water;
+        }
+
+        /*  Standard Accessor */
+        RingPolicy getPolicy()
+        {
+            return policy;
+        }
+
+    private:
+        /* Disallow copy */
+        TelemetryRing(const TelemetryRing&);
+        TelemetryRing &operator=(const TelemetryRing&);
+
+    protected:
+        /* Members */
+        RingPolicy policy;
+        T pool[N];
+
+        /* Written by the producer only */
+        volatile uint32_t head;
+        uint32_t rejected;
+        uint32_t high_water;
+
+        /* Written by the consumer only */
+        volatile uint32_t tail;
+        uint32_t overwritten;
+};
+
+#endif
@@ -0,0 +1,43 @@
+//************************************************************************
+//
+//  Stream.h
+//
+//  Host build only.
+//
+//  Stand-in for mbed::Stream: formatted output funnelled through the
+//  _putc() of the derived class.
+//
+//************************************************************************
+#ifndef __SIM_STREAM_H__
+#define __SIM_STREAM_H__
+
+#include <stdarg.h>
+#include <stddef.h>
+
+namespace mbed {
+
+class Stream
+{
+    public:
+        Stream(const char *name=NULL);
+        virtual ~Stream();
+
+        int putc(int c);
+        int puts(const char *s);
+        int getc();
+        int printf(const char *format, ...);
+        int vprintf(const char *format, va_list args);
+
+    protected:
+        virtual int _putc(int c) = 0;
+        virtual int _getc() = 0;
+
+    private:
+        /* disallow copy constructor and assignment operators */
+        Stream(const Stream&);
+        Stream & operator = (const Stream&);
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+//************************************************************************
+//
+//  cmsis_os.h
+//
+//  Host build only.
+//
+//  Subset of the CMSIS-RTOS types used by the application code, with the
+//  same names and values as mbed-rtos/rtx/TARGET_CORTEX_M/cmsis_os.h so
+//  that car.cpp and controller.cpp compile unchanged against the
+//  simulated kernel.
+//
+//************************************************************************
+#ifndef __SIM_CMSIS_OS_H__
+#define __SIM_CMSIS_OS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define osWaitForever     0xFFFFFFFF
+
+#define DEFAULT_STACK_SIZE  2048
+
+typedef enum  {
+  osPriorityIdle          = -3,
+  osPriorityLow           = -2,
+  osPriorityBelowNormal   = -1,
+  osPriorityNormal        =  0,
+  osPriorityAboveNormal   = +1,
+  osPriorityHigh          = +2,
+  osPriorityRealtime      = +3,
+  osPriorityError         =  0x84
+} osPriority;
+
+typedef enum  {
+  osOK                    =     0,
+  osEventSignal           =  0x08,
+  osEventMessage          =  0x10,
+  osEventMail             =  0x20,
+  osEventTimeout          =  0x40,
+  osErrorParameter        =  0x80,
+  osErrorResource         =  0x81,
+  osErrorTimeoutResource  =  0xC1,
+  osErrorISR              =  0x82,
+  osErrorISRRecursive     =  0x83,
+  osErrorPriority         =  0x84,
+  osErrorNoMemory         =  0x85,
+  osErrorValue            =  0x86,
+  osErrorOS               =  0xFF,
+  os_status_reserved      =  0x7FFFFFFF
+} osStatus;
+
+namespace sim { struct Task; }
+
+typedef sim::Task *osThreadId;
+typedef void *osMailQId;
+typedef void *osMessageQId;
+
+typedef struct  {
+  osStatus                 status;
+  union  {
+    uint32_t                    v;
+    void                       *p;
+    int32_t               signals;
+  } value;
+  union  {
+    osMailQId             mail_id;
+    osMessageQId       message_id;
+  } def;
+} osEvent;
+
+/* Stack usage (mbed extension), see rtos.cpp: no idle or timer thread here */
+osThreadId osThreadGetIdleId();
+osThreadId osThreadGetTimerId();
+uint32_t osThreadStackSize(osThreadId thread_id);
+uint32_t osThreadStackMax(osThreadId thread_id);
+
+#endif
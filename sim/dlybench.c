@@ -0,0 +1,331 @@
+//************************************************************************
+//
+//  dlybench.c
+//
+//  Host build only.
+//
+//  Delay list benchmark, see dlybench.h. Compiled as C against the RTX
+//  headers: the wheel path is rt_DlyWheel.h itself, the chain path is
+//  rt_put_dly, rt_dec_dly and rt_rmv_dly with the CMSIS timer list of
+//  rt_CMSIS.c, less the ready list and message queue hand-over.
+//
+//************************************************************************
+
+/* Header includes */
+#include "dlybench.h"
+
+/* RTX includes, ahead of the standard headers that define NULL */
+#include "../mbed-rtos/rtx/TARGET_CORTEX_M/rt_TypeDef.h"
+#include "../mbed-rtos/rtx/TARGET_CORTEX_M/rt_DlyWheel.h"
+
+/* Standard includes */
+#include <time.h>
+
+/* Longest task sleep and timer period, in ticks */
+#define SLEEP_MAX       500
+#define PERIOD_MAX      1000
+
+static struct OS_TCB tcb[DLY_BENCH_TASKS];
+static struct OS_TMR tmr[DLY_BENCH_TIMERS];
+static U16 period[DLY_BENCH_TIMERS];
+
+static struct OS_TCB dly;           // list head, as os_dly
+static P_TMR tmr_head;
+static struct OS_DLYWHEEL dly_wheel;
+static struct OS_TMRWHEEL tmr_wheel;
+static U16 now;
+
+static uint32_t seed;
+static P_TCB due[DLY_BENCH_TASKS];
+static uint32_t sum;
+static uint64_t releases;
+static uint64_t inserts;
+
+/*  Monotonic clock */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*  Same pseudo random sequence on both paths */
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 16;
+}
+
+/*  Delta chain insert, rt_put_dly */
+static void chain_put(P_TCB p_task, U16 delay)
+{
+    P_TCB p;
+    U32 delta, idelay = delay;
+
+    p = (P_TCB)&dly;
+    if (p->p_dlnk == NULL) {
+        delta = 0;
+        goto last;
+    }
+    delta = dly.delta_time;
+    while (delta < idelay) {
+        if (p->p_dlnk == NULL) {
+last:       p_task->p_dlnk = NULL;
+            p->p_dlnk = p_task;
+            p_task->p_blnk = p;
+            p->delta_time = (U16)(idelay - delta);
+            p_task->delta_time = 0;
+            return;
+        }
+        p = p->p_dlnk;
+        delta += p->delta_time;
+    }
+    p_task->p_dlnk = p->p_dlnk;
+    p->p_dlnk = p_task;
+    p_task->p_blnk = p;
+    if (p_task->p_dlnk != NULL) {
+        p_task->p_dlnk->p_blnk = p_task;
+    }
+    p_task->delta_time = (U16)(delta - idelay);
+    p->delta_time -= p_task->delta_time;
+}
+
+/*  Delta chain tick, rt_dec_dly */
+static uint32_t chain_tick(void)
+{
+    P_TCB p_rdy;
+    uint32_t n = 0;
+
+    if (dly.p_dlnk == NULL) {
+        return 0;
+    }
+    dly.delta_time--;
+    while ((dly.delta_time == 0) && (dly.p_dlnk != NULL)) {
+        p_rdy = dly.p_dlnk;
+        dly.delta_time = p_rdy->delta_time;
+        dly.p_dlnk = p_rdy->p_dlnk;
+        if (p_rdy->p_dlnk != NULL) {
+            p_rdy->p_dlnk->p_blnk = (P_TCB)&dly;
+            p_rdy->p_dlnk = NULL;
+        }
+        p_rdy->p_blnk = NULL;
+        due[n++] = p_rdy;
+    }
+    return n;
+}
+
+/*  Delta chain removal, rt_rmv_dly */
+static void chain_rmv(P_TCB p_task)
+{
+    P_TCB p_b;
+
+    p_b = p_task->p_blnk;
+    if (p_b != NULL) {
+        p_b->p_dlnk = p_task->p_dlnk;
+        if (p_task->p_dlnk != NULL) {
+            p_b->delta_time += p_task->delta_time;
+            p_task->p_dlnk->p_blnk = p_b;
+            p_task->p_dlnk = NULL;
+        }
+        else {
+            p_b->delta_time = 0;
+        }
+        p_task->p_blnk = NULL;
+    }
+}
+
+/*  Timer list insert, rt_timer_insert */
+static void chain_tput(P_TMR pt, U32 tcnt)
+{
+    P_TMR p, prev;
+
+    prev = NULL;
+    p = tmr_head;
+    while (p != NULL) {
+        if (tcnt < p->tcnt) break;
+        tcnt -= p->tcnt;
+        prev = p;
+        p = p->next;
+    }
+    pt->next = p;
+    pt->tcnt = (U16)tcnt;
+    if (p != NULL) {
+        p->tcnt -= pt->tcnt;
+    }
+    if (prev != NULL) {
+        prev->next = pt;
+    } else {
+        tmr_head = pt;
+    }
+}
+
+/*  Timer list tick, sysTimerTick with every timer periodic */
+static void chain_ttick(void)
+{
+    P_TMR pt, p;
+
+    p = tmr_head;
+    if (p == NULL) return;
+
+    p->tcnt--;
+    while ((p != NULL) && (p->tcnt == 0)) {
+        pt = p;
+        p = p->next;
+        tmr_head = p;
+        sum = sum * 31 + (uint32_t)(pt - tmr) + 1;
+        releases++;
+        inserts++;
+        chain_tput(pt, period[pt - tmr]);
+    }
+}
+
+/*  Wheel insert */
+static void wheel_put(P_TCB p_task, U16 delay)
+{
+    rt_wheel_put(&dly_wheel, p_task, (U16)(now + delay));
+}
+
+/*  Wheel tick */
+static uint32_t wheel_tick(void)
+{
+    P_TCB p_rdy;
+    uint32_t n = 0;
+
+    while ((p_rdy = rt_wheel_get(&dly_wheel, now)) != NULL)
+        due[n++] = p_rdy;
+    return n;
+}
+
+/*  Wheel removal */
+static void wheel_rmv(P_TCB p_task)
+{
+    if (p_task->p_blnk != NULL)
+        rt_wheel_rmv(&dly_wheel, p_task);
+}
+
+/*  Timer wheel insert */
+static void wheel_tput(P_TMR pt, U32 tcnt)
+{
+    rt_twheel_put(&tmr_wheel, pt, (U16)(now + tcnt));
+}
+
+/*  Timer wheel tick */
+static void wheel_ttick(void)
+{
+    P_TMR pt;
+
+    while ((pt = rt_twheel_get(&tmr_wheel, now)) != NULL) {
+        sum = sum * 31 + (uint32_t)(pt - tmr) + 1;
+        releases++;
+        inserts++;
+        wheel_tput(pt, period[pt - tmr]);
+    }
+}
+
+typedef struct {
+    void (*put)(P_TCB, U16);
+    uint32_t (*tick)(void);
+    void (*rmv)(P_TCB);
+    void (*tput)(P_TMR, U32);
+    void (*ttick)(void);
+} Path;
+
+/*  One path */
+//  @brief  every task sleeps 1 - SLEEP_MAX ticks, sleeps again as soon as
+//          it is released, and one tick in four a random task is woken
+//          early and goes back to sleep; timers are periodic
+//  @param  ns      set to the time taken by the ticks
+//  @return checksum of the release sequence
+static uint32_t run(const Path *path, uint32_t tasks, uint32_t timers, uint32_t ticks,
+                    uint64_t *ns)
+{
+    uint32_t i, t;
+    uint64_t t0;
+
+    seed = 54321;
+    sum = 0;
+    releases = 0;
+    inserts = 0;
+    now = 0;
+    dly.p_dlnk = NULL;
+    dly.delta_time = 0;
+    tmr_head = NULL;
+    for (i = 0; i < OS_DLY_SLOTS; i++)
+    {
+        dly_wheel.slot[i] = NULL;
+        tmr_wheel.slot[i] = NULL;
+    }
+    dly_wheel.count = 0;
+    tmr_wheel.count = 0;
+
+    for (i = 0; i < tasks; i++)
+    {
+        tcb[i].p_dlnk = NULL;
+        tcb[i].p_blnk = NULL;
+        path->put(&tcb[i], (U16)(1 + rnd() % SLEEP_MAX));
+    }
+    for (i = 0; i < timers; i++)
+    {
+        period[i] = (U16)(1 + rnd() % PERIOD_MAX);
+        path->tput(&tmr[i], period[i]);
+    }
+
+    t0 = now_ns();
+    for (t = 0; t < ticks; t++)
+    {
+        uint32_t n;
+
+        now++;
+        n = path->tick();
+        path->ttick();
+        for (i = 0; i < n; i++)
+        {
+            sum = sum * 31 + (uint32_t)(due[i] - tcb);
+            path->put(due[i], (U16)(1 + rnd() % SLEEP_MAX));
+        }
+        releases += n;
+        inserts += n;
+        if (tasks && rnd() % 4 == 0)
+        {
+            P_TCB p = &tcb[rnd() % tasks];
+            path->rmv(p);
+            path->put(p, (U16)(1 + rnd() % SLEEP_MAX));
+            inserts++;
+        }
+    }
+    *ns = now_ns() - t0;
+    return sum;
+}
+
+static const Path chain = { chain_put, chain_tick, chain_rmv, chain_tput, chain_ttick };
+static const Path wheel = { wheel_put, wheel_tick, wheel_rmv, wheel_tput, wheel_ttick };
+
+/*  Benchmarks one task and timer count */
+//  @param  tasks   sleeping tasks, up to DLY_BENCH_TASKS
+//  @param  timers  periodic timers, up to DLY_BENCH_TIMERS
+//  @param  ticks   system ticks to run
+//  @param  result  times per tick
+void benchmarkDelays(uint32_t tasks, uint32_t timers, uint32_t ticks,
+                     DelayBenchmark *result)
+{
+    uint64_t chain_ns, wheel_ns;
+    uint32_t chain_sum, wheel_sum;
+
+    if (tasks > DLY_BENCH_TASKS)
+        tasks = DLY_BENCH_TASKS;
+    if (timers > DLY_BENCH_TIMERS)
+        timers = DLY_BENCH_TIMERS;
+
+    chain_sum = run(&chain, tasks, timers, ticks, &chain_ns);
+    wheel_sum = run(&wheel, tasks, timers, ticks, &wheel_ns);
+
+    result->tasks = tasks;
+    result->timers = timers;
+    result->ticks = ticks;
+    result->slots = OS_DLY_SLOTS;
+    result->releases = releases;
+    result->inserts = inserts;
+    result->mismatches = chain_sum != wheel_sum;
+    result->chain = (double)chain_ns / ticks;
+    result->wheel = (double)wheel_ns / ticks;
+}
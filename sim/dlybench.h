@@ -0,0 +1,50 @@
+//************************************************************************
+//
+//  dlybench.h
+//
+//  Host build only.
+//
+//  Stress benchmark of the RTX delay list and user timers: the delta
+//  sorted chains of rt_put_dly and rt_timer_insert against the timing
+//  wheels of rt_DlyWheel.h (OS_DLY_WHEEL), driven tick by tick with the
+//  same sleeps, early wake-ups and periodic timers.
+//
+//  Functions:
+//          -benchmarkDelays        times the given number of ticks for
+//                                  one task and timer count
+//
+//************************************************************************
+#ifndef __DLYBENCH_H__
+#define __DLYBENCH_H__
+
+#include <stdint.h>
+
+/* Largest task and timer counts benchmarked */
+#define DLY_BENCH_TASKS     1024
+#define DLY_BENCH_TIMERS    1024
+
+/* Benchmark results, times in host ns per tick */
+typedef struct {
+    uint32_t tasks;
+    uint32_t timers;
+    uint32_t ticks;
+    uint32_t slots;             // timing wheel slots
+    uint64_t releases;          // tasks and timers released
+    uint64_t inserts;           // tasks and timers put
+    uint32_t mismatches;        // 1 if the release sequences differ
+    double chain;
+    double wheel;
+} DelayBenchmark;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void benchmarkDelays(uint32_t tasks, uint32_t timers, uint32_t ticks,
+                     DelayBenchmark *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
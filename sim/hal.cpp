@@ -0,0 +1,828 @@
+//************************************************************************
+//
+//  hal.cpp
+//
+//  Host build only.
+//
+//  Simulated board: pin table, wait API, UART, I2C bus and the WattBob
+//  MCP23017 + HD44780 display models.
+//
+//************************************************************************
+
+/* Header includes */
+#include "mbed.h"
+
+/* Cycle counter includes */
+#include "cycles.h"
+
+/* Standard includes */
+#include <chrono>
+#include <deque>
+#include <map>
+
+/*------------------------------------------------------------------------
+ * wait_api.h, us_ticker_api.h
+ */
+void wait(float s)
+{
+    sim::busy((uint64_t)(s * 1e6f + 0.5f));
+}
+
+void wait_ms(int ms)
+{
+    sim::busy((uint64_t)ms * 1000);
+}
+
+void wait_us(int us)
+{
+    sim::busy((uint64_t)us);
+}
+
+uint32_t us_ticker_read(void)
+{
+    return (uint32_t)sim::now_us();
+}
+
+/*------------------------------------------------------------------------
+ * cycles.h: real time spent on the host, the virtual clock does not
+ * advance while application code runs
+ */
+uint32_t cyclesRead()
+{
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+namespace sim {
+
+/*------------------------------------------------------------------------
+ * Pins
+ */
+static int digital[PIN_COUNT];
+static float analog[PIN_COUNT];
+static float pulse[PIN_COUNT];
+
+static irq_fn pin_fn[PIN_COUNT];
+static void *pin_arg[PIN_COUNT];
+
+void set_digital(int pin, int value)
+{
+    if (digital[pin] == value)
+        return;
+    digital[pin] = value;
+    if (pin_fn[pin])
+        schedule_irq(now_us(), pin_fn[pin], pin_arg[pin]);
+}
+
+void pin_irq(int pin, irq_fn fn, void *arg)
+{
+    pin_fn[pin] = fn;
+    pin_arg[pin] = arg;
+}
+
+int get_digital(int pin)
+{
+    return digital[pin];
+}
+
+void set_analog(int pin, float value)
+{
+    analog[pin] = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
+
+float get_analog(int pin)
+{
+    return analog[pin];
+}
+
+static float analog_noise;
+static uint64_t noise_seed = 0x9E3779B97F4A7C15ull;
+
+void set_analog_noise(float sigma)
+{
+    analog_noise = sigma;
+}
+
+/*  Uniform in (0, 1], xorshift64* so runs are reproducible */
+static double uniform()
+{
+    noise_seed ^= noise_seed >> 12;
+    noise_seed ^= noise_seed << 25;
+    noise_seed ^= noise_seed >> 27;
+    return ((noise_seed * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0) + 1e-300;
+}
+
+float sample_analog(int pin)
+{
+    float value = analog[pin];
+    if (analog_noise > 0.0f)
+    {
+        // Box-Muller
+        double gauss = sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+        value += (float)(gauss * analog_noise);
+    }
+    return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
+
+void set_pulsewidth(int pin, float seconds)
+{
+    pulse[pin] = seconds;
+}
+
+float get_pulsewidth(int pin)
+{
+    return pulse[pin];
+}
+
+/*------------------------------------------------------------------------
+ * UART
+ *
+ * 16-byte TX FIFO: a blocking putc only waits once the FIFO is full
+ */
+static const int UART_FIFO = 16;
+static int uart_rate = 9600;
+static bool uart_stdout;
+static void (*uart_receiver)(int c);
+static irq_fn uart_thre;
+static void *uart_thre_arg;
+static uint64_t uart_thre_handle;
+static uint64_t line_idle_at;
+static std::deque<int> uart_rx_fifo;
+
+void uart_baud(int baud)
+{
+    uart_rate = baud;
+}
+
+void uart_echo(bool on)
+{
+    uart_stdout = on;
+}
+
+void uart_tap(void (*receiver)(int c))
+{
+    uart_receiver = receiver;
+}
+
+void uart_rx(int c)
+{
+    uart_rx_fifo.push_back(c & 0xFF);
+}
+
+int uart_rx_count()
+{
+    return (int)uart_rx_fifo.size();
+}
+
+int uart_rx_get()
+{
+    if (uart_rx_fifo.empty())
+        return -1;
+    int c = uart_rx_fifo.front();
+    uart_rx_fifo.pop_front();
+    return c;
+}
+
+int uart_space()
+{
+    uint64_t ch = uart_char_us();
+    uint64_t now = now_us();
+    if (line_idle_at <= now)
+        return UART_FIFO;
+    // Characters still queued, the one on the wire included
+    int queued = (int)((line_idle_at - now + ch - 1) / ch);
+    return queued < UART_FIFO ? UART_FIFO - queued : 0;
+}
+
+void uart_tx_irq(irq_fn fn, void *arg)
+{
+    uart_thre = fn;
+    uart_thre_arg = arg;
+    if (!fn && uart_thre_handle)
+    {
+        cancel_irq(uart_thre_handle);
+        uart_thre_handle = 0;
+    }
+}
+
+static void uart_thre_fire(void *arg)
+{
+    (void)arg;
+    uart_thre_handle = 0;
+    if (uart_thre)
+        uart_thre(uart_thre_arg);
+}
+
+uint64_t uart_char_us()
+{
+    return (10 * 1000000ULL + uart_rate / 2) / uart_rate;
+}
+
+void uart_put(int c)
+{
+    uint64_t ch = uart_char_us();
+    uint64_t now = now_us();
+
+    if (line_idle_at > now + UART_FIFO * ch)
+    {
+        uint64_t stall = line_idle_at - UART_FIFO * ch - now;
+        stats.uart_wait_us += stall;
+        busy(stall);
+        now = now_us();
+    }
+    line_idle_at = (line_idle_at > now ? line_idle_at : now) + ch;
+    stats.uart_bytes++;
+
+    if (uart_stdout)
+        putchar(c);
+    if (uart_receiver)
+        uart_receiver(c);
+
+    // THRE fires once the FIFO has drained
+    if (uart_thre)
+    {
+        if (uart_thre_handle)
+            cancel_irq(uart_thre_handle);
+        uart_thre_handle = schedule_irq(line_idle_at, uart_thre_fire, NULL);
+    }
+}
+
+/*------------------------------------------------------------------------
+ * I2C bus
+ */
+static std::map<int, I2CDevice*> &bus()
+{
+    static std::map<int, I2CDevice*> devices;
+    return devices;
+}
+
+I2CDevice::I2CDevice(int address)
+: _address(address)
+{
+    bus()[address] = this;
+}
+
+I2CDevice::~I2CDevice()
+{
+    bus().erase(_address);
+}
+
+/*  Bus time of one transfer */
+//  @brief  start + address byte + data bytes (9 clocks each) + stop
+static void transfer(int length, int hz)
+{
+    stats.i2c_transactions++;
+    stats.i2c_bytes += length;
+    busy(((uint64_t)(length + 1) * 9 + 2) * 1000000ULL / hz);
+}
+
+int i2c_write(int address, const char *data, int length, int hz)
+{
+    transfer(length, hz);
+    std::map<int, I2CDevice*>::iterator it = bus().find(address & 0xFE);
+    if (it == bus().end())
+        return 1;
+    return it->second->write(data, length);
+}
+
+int i2c_read(int address, char *data, int length, int hz)
+{
+    transfer(length, hz);
+    std::map<int, I2CDevice*>::iterator it = bus().find(address & 0xFE);
+    if (it == bus().end())
+        return 1;
+    return it->second->read(data, length);
+}
+
+/*------------------------------------------------------------------------
+ * HD44780
+ */
+Hd44780::Hd44780()
+: _address(0),
+  _four_bit(false),
+  _high_nibble(true),
+  _latched(0),
+  _e(false),
+  _rw(false),
+  _read_high(true),
+  _busy_until(0),
+  _commands(0),
+  _characters(0)
+{
+    memset(_ddram, ' ', sizeof(_ddram));
+}
+
+void Hd44780::update(bool rs, bool rw, bool e, int data)
+{
+    bool falling = _e && !e;
+    _e = e;
+    _rw = rw;
+    if (!falling)
+        return;
+
+    // 4-bit reads come out as two nibbles, one per E pulse
+    if (rw)
+    {
+        _read_high = !_four_bit || !_read_high;
+        return;
+    }
+    _read_high = true;
+
+    if (!_four_bit)
+    {
+        // 8-bit mode with only D4-D7 wired: the low nibble reads as 0
+        execute(rs, (data & 0x0F) << 4);
+    }
+    else if (_high_nibble)
+    {
+        _latched = data & 0x0F;
+        _high_nibble = false;
+    }
+    else
+    {
+        _high_nibble = true;
+        execute(rs, (_latched << 4) | (data & 0x0F));
+    }
+}
+
+int Hd44780::bus() const
+{
+    if (!_rw || !_e)
+        return -1;
+    bool busy = now_us() < _busy_until;
+    int ac = _address & 0x7F;
+    if (_read_high)
+        return (busy ? 0x08 : 0) | (ac >> 4);
+    return ac & 0x0F;
+}
+
+void Hd44780::execute(bool rs, int value)
+{
+    // Execution times at 270kHz: 1.52ms for clear and home, 37us otherwise
+    bool slow = !rs && (value == 0x01 || (value & 0xFE) == 0x02);
+    _busy_until = now_us() + (slow ? 1520 : 37);
+
+    if (rs)
+    {
+        _ddram[_address] = (char)value;
+        _characters++;
+        // 40 characters per line, line 2 starts at 0x40
+        _address++;
+        if (_address == 0x28)
+            _address = 0x40;
+        else if (_address == 0x68)
+            _address = 0x00;
+        return;
+    }
+
+    _commands++;
+    if (value & 0x80)
+        _address = value & 0x7F;
+    else if (value & 0x40)
+        ;   // CGRAM address, not modelled
+    else if (value & 0x20)
+    {
+        _four_bit = !(value & 0x10);
+        _high_nibble = true;
+    }
+    else if (value & 0x1C)
+        ;   // shift, display control and entry mode: fixed configuration
+    else if (value & 0x02)
+        _address = 0;
+    else if (value & 0x01)
+    {
+        memset(_ddram, ' ', sizeof(_ddram));
+        _address = 0;
+    }
+}
+
+const char *Hd44780::row(int r)
+{
+    memcpy(_row, &_ddram[r ? 0x40 : 0x00], 16);
+    _row[16] = '\0';
+    return _row;
+}
+
+/*------------------------------------------------------------------------
+ * MCP23017
+ */
+enum {
+    IODIRA = 0x00, IPOLA = 0x02, GPINTENA = 0x04, DEFVALA = 0x06,
+    INTCONA = 0x08, IOCONA = 0x0A, IOCONB = 0x0B, INTFA = 0x0E,
+    INTFB = 0x0F, INTCAPA = 0x10, INTCAPB = 0x11, GPIOA = 0x12,
+    GPIOB = 0x13, OLATA = 0x14, OLATB = 0x15, REGS = 0x16,
+    INTPOL = 0x02, SEQOP = 0x20, MIRROR = 0x40
+};
+
+Mcp23017::Mcp23017(int address, Hd44780 *lcd)
+: I2CDevice(address),
+  _pointer(0),
+  _inputs(0),
+  _previous(0),
+  _int_pin(-1),
+  _lcd(lcd)
+{
+    memset(_reg, 0, sizeof(_reg));
+    _reg[IODIRA] = 0xFF;
+    _reg[IODIRA + 1] = 0xFF;
+}
+
+/*  Address pointer */
+//  @brief  sequential mode walks the register map, byte mode
+//          (IOCON.SEQOP) toggles between the A and B halves of a pair
+void Mcp23017::next()
+{
+    if (_reg[IOCONA] & SEQOP)
+        _pointer ^= 1;
+    else
+        _pointer = (_pointer + 1) % REGS;
+}
+
+uint16_t Mcp23017::reg16(int address) const
+{
+    return _reg[address] | (_reg[address + 1] << 8);
+}
+
+uint16_t Mcp23017::gpio()
+{
+    uint16_t dir = _reg[IODIRA] | (_reg[IODIRA + 1] << 8);
+    uint16_t pol = _reg[IPOLA] | (_reg[IPOLA + 1] << 8);
+    uint16_t lat = _reg[OLATA] | (_reg[OLATB] << 8);
+    uint16_t pins = _inputs;
+
+    // The display drives D4-D7 (GPA0-3) while it is being read
+    int lcd = _lcd ? _lcd->bus() : -1;
+    if (lcd >= 0)
+        pins = (pins & ~0x000F) | lcd;
+
+    return (lat & ~dir) | ((pins ^ pol) & dir);
+}
+
+void Mcp23017::outputs_changed()
+{
+    if (_lcd == NULL)
+        return;
+    // WattBob wiring: D4-D7 on GPA0-3, E on GPA5, RW on GPA6, RS on GPA7
+    uint8_t a = _reg[OLATA];
+    _lcd->update(a & 0x80, a & 0x40, a & 0x20, a & 0x0F);
+}
+
+int Mcp23017::write(const char *data, int length)
+{
+    if (length < 1)
+        return 0;
+
+    _pointer = data[0] % REGS;
+    for (int i = 1; i < length; i++)
+    {
+        int reg = _pointer;
+        uint8_t value = data[i];
+
+        if (reg == GPIOA || reg == GPIOB)
+            reg += OLATA - GPIOA;
+        if (reg == IOCONA || reg == IOCONB)
+        {
+            _reg[IOCONA] = value;
+            _reg[IOCONB] = value;
+        }
+        else if (reg < INTFA || reg > INTCAPB)
+            _reg[reg] = value;
+
+        if (reg == OLATA)
+            outputs_changed();
+        next();
+    }
+    interrupts();
+    return 0;
+}
+
+int Mcp23017::read(char *data, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        uint16_t port = gpio();
+        if (_pointer == GPIOA)
+            data[i] = port & 0xFF;
+        else if (_pointer == GPIOB)
+            data[i] = port >> 8;
+        else
+            data[i] = _reg[_pointer];
+
+        // Reading GPIO or INTCAP of a port clears its flags
+        if (_pointer == GPIOA || _pointer == INTCAPA)
+            _reg[INTFA] = 0;
+        else if (_pointer == GPIOB || _pointer == INTCAPB)
+            _reg[INTFB] = 0;
+        next();
+    }
+    interrupts();
+    return 0;
+}
+
+void Mcp23017::set_inputs(uint16_t levels)
+{
+    _inputs = levels;
+    interrupts();
+}
+
+void Mcp23017::connect_int(int pin)
+{
+    _int_pin = pin;
+    drive_int();
+}
+
+/*  Interrupt on change */
+//  @brief  flags enabled inputs that differ from their previous level,
+//          or from DEFVAL when INTCON is set; the port is captured in
+//          INTCAP when its first flag rises
+void Mcp23017::interrupts()
+{
+    uint16_t port = gpio();
+    uint16_t con = reg16(INTCONA);
+    uint16_t diff = (con & (port ^ reg16(DEFVALA))) | (~con & (port ^ _previous));
+    uint16_t hit = diff & reg16(GPINTENA) & reg16(IODIRA) & ~reg16(INTFA);
+    _previous = port;
+
+    if (hit & 0x00FF)
+    {
+        if (_reg[INTFA] == 0)
+            _reg[INTCAPA] = port & 0xFF;
+        _reg[INTFA] |= hit & 0xFF;
+    }
+    if (hit & 0xFF00)
+    {
+        if (_reg[INTFB] == 0)
+            _reg[INTCAPB] = port >> 8;
+        _reg[INTFB] |= hit >> 8;
+    }
+    drive_int();
+}
+
+/*  INTA output */
+void Mcp23017::drive_int()
+{
+    if (_int_pin < 0)
+        return;
+    bool active = _reg[INTFA] || ((_reg[IOCONA] & MIRROR) && _reg[INTFB]);
+    bool high = (_reg[IOCONA] & INTPOL) != 0;
+    set_digital(_int_pin, active == high);
+}
+
+}
+
+namespace mbed {
+
+/*------------------------------------------------------------------------
+ * Stream
+ */
+Stream::Stream(const char *name)
+{
+    (void)name;
+}
+
+Stream::~Stream()
+{
+}
+
+int Stream::putc(int c)
+{
+    return _putc(c);
+}
+
+int Stream::puts(const char *s)
+{
+    int n = 0;
+    while (*s)
+    {
+        _putc(*s++);
+        n++;
+    }
+    return n;
+}
+
+int Stream::getc()
+{
+    return _getc();
+}
+
+int Stream::printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+int Stream::vprintf(const char *format, va_list args)
+{
+    char buffer[256];
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    if (n >= (int)sizeof(buffer))
+        n = sizeof(buffer) - 1;
+    for (int i = 0; i < n; i++)
+        _putc(buffer[i]);
+    return n;
+}
+
+/*------------------------------------------------------------------------
+ * AnalogIn
+ */
+float AnalogIn::read()
+{
+    return read_u16() / 65535.0f;
+}
+
+unsigned short AnalogIn::read_u16()
+{
+    // 12-bit result replicated into the low bits like the LPC1768 HAL
+    unsigned int value = (unsigned int)(sim::sample_analog(_pin) * 4095.0f + 0.5f);
+    return (unsigned short)((value << 4) | (value >> 8));
+}
+
+/*------------------------------------------------------------------------
+ * Timer
+ */
+uint64_t Timer::elapsed()
+{
+    return _time + (_running ? sim::now_us() - _start : 0);
+}
+
+void Timer::start()
+{
+    if (!_running)
+    {
+        _start = sim::now_us();
+        _running = true;
+    }
+}
+
+void Timer::stop()
+{
+    _time = elapsed();
+    _running = false;
+}
+
+void Timer::reset()
+{
+    _start = sim::now_us();
+    _time = 0;
+}
+
+float Timer::read()
+{
+    return elapsed() / 1000000.0f;
+}
+
+int Timer::read_ms()
+{
+    return (int)(elapsed() / 1000);
+}
+
+int Timer::read_us()
+{
+    return (int)elapsed();
+}
+
+/*------------------------------------------------------------------------
+ * Ticker
+ */
+void Ticker::start(uint64_t period_us)
+{
+    detach();
+    _period = period_us ? period_us : 1;
+    _next = sim::now_us() + _period;
+    _handle = sim::schedule_irq(_next, &Ticker::tick, this);
+}
+
+void Ticker::detach()
+{
+    if (_handle)
+        sim::cancel_irq(_handle);
+    _handle = 0;
+}
+
+/*  Fires on an absolute grid, like the us_ticker based original */
+void Ticker::tick(void *p)
+{
+    Ticker *ticker = (Ticker*)p;
+    ticker->_next += ticker->_period;
+    ticker->_handle = sim::schedule_irq(ticker->_next, &Ticker::tick, ticker);
+    ticker->_fn.call();
+}
+
+/*------------------------------------------------------------------------
+ * InterruptIn
+ */
+InterruptIn::InterruptIn(PinName pin)
+: _pin(pin),
+  _level(sim::get_digital(pin))
+{
+    sim::pin_irq(pin, &InterruptIn::edge, this);
+}
+
+InterruptIn::~InterruptIn()
+{
+    sim::pin_irq(_pin, NULL, NULL);
+}
+
+/*  Pin change interrupt */
+//  @brief  every change is queued on the timeline, the level seen when
+//          it runs decides the edge
+void InterruptIn::edge(void *p)
+{
+    InterruptIn *in = (InterruptIn*)p;
+    int level = in->read();
+    if (level == in->_level)
+        return;
+    in->_level = level;
+    if (level)
+        in->_rise.call();
+    else
+        in->_fall.call();
+}
+
+/*------------------------------------------------------------------------
+ * Serial
+ */
+SerialBase::SerialBase(PinName tx, PinName rx)
+{
+    (void)tx;
+    (void)rx;
+}
+
+void SerialBase::baud(int baudrate)
+{
+    sim::uart_baud(baudrate);
+}
+
+int SerialBase::readable()
+{
+    return sim::uart_rx_count() > 0;
+}
+
+int SerialBase::writeable()
+{
+    return sim::uart_space() > 0;
+}
+
+void SerialBase::attach(void (*fptr)(void), IrqType type)
+{
+    _irq[type].attach(fptr);
+    enable(type, fptr != NULL);
+}
+
+void SerialBase::enable(IrqType type, bool on)
+{
+    if (type == TxIrq)
+        sim::uart_tx_irq(on ? &SerialBase::txInterrupt : NULL, this);
+}
+
+void SerialBase::txInterrupt(void *p)
+{
+    ((SerialBase*)p)->_irq[TxIrq].call();
+}
+
+int SerialBase::_base_putc(int c)
+{
+    sim::uart_put(c);
+    return c;
+}
+
+int SerialBase::_base_getc()
+{
+    return sim::uart_rx_get();
+}
+
+Serial::Serial(PinName tx, PinName rx, const char *name)
+: SerialBase(tx, rx),
+  Stream(name)
+{
+}
+
+int Serial::_putc(int c)
+{
+    return _base_putc(c);
+}
+
+int Serial::_getc()
+{
+    return _base_getc();
+}
+
+RawSerial::RawSerial(PinName tx, PinName rx)
+: SerialBase(tx, rx)
+{
+}
+
+int RawSerial::putc(int c)
+{
+    return _base_putc(c);
+}
+
+int RawSerial::getc()
+{
+    return _base_getc();
+}
+
+}
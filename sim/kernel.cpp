@@ -0,0 +1,397 @@
+//************************************************************************
+//
+//  kernel.cpp
+//
+//  Host build only.
+//
+//  Virtual-time coroutine kernel behind the simulated rtos::Thread,
+//  Semaphore, Mutex and Mail.
+//
+//************************************************************************
+
+/* Header includes */
+#include "sim.h"
+#include "cmsis_os.h"
+
+/* Standard includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace sim {
+
+Stats stats;
+
+/* Host stack given to every task, target stack sizes are far too small
+   for the host C library */
+static const uint32_t HOST_STACK_SIZE = 256 * 1024;
+
+/* Fill of the host stacks, the word mbed-rtos fills target stacks with */
+static const uint32_t STACK_FILL = 0xE25A2EA5;
+
+/* Priority levels, osPriorityIdle .. osPriorityRealtime */
+static const int LEVELS = 7;
+
+/* Timed event: either a task wake-up or an interrupt callback */
+struct Timer
+{
+    uint64_t at;
+    Task *task;
+    irq_fn fn;
+    void *arg;
+};
+
+static uint64_t clock_us;
+static uint64_t next_key = 1;
+static bool irq_active;
+static bool irq_masked;
+
+static Task main_task;
+static Task *running;
+static std::deque<Task*> ready_list[LEVELS];
+
+/* Ordered by (time, key) so that equal deadlines fire in FIFO order */
+static std::set<std::pair<uint64_t, uint64_t> > timeline;
+static std::map<uint64_t, Timer> timers;
+
+/*  Lazy initialisation */
+//  @brief  adopts the main() context as the first running task
+static void init()
+{
+    if (running)
+        return;
+    main_task.priority = osPriorityNormal;
+    main_task.state = Task::RUNNING;
+    main_task.stack_size = HOST_STACK_SIZE;
+    running = &main_task;
+}
+
+/*  Ready queue helpers */
+static std::deque<Task*> &level(Task *task)
+{
+    return ready_list[task->priority - osPriorityIdle];
+}
+
+static Task *pop_ready()
+{
+    for (int i = LEVELS - 1; i >= 0; i--)
+    {
+        if (!ready_list[i].empty())
+        {
+            Task *task = ready_list[i].front();
+            ready_list[i].pop_front();
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static int top_ready_priority()
+{
+    for (int i = LEVELS - 1; i >= 0; i--)
+        if (!ready_list[i].empty())
+            return i + osPriorityIdle;
+    return osPriorityIdle - 1;
+}
+
+/*  Timeline helpers */
+static uint64_t arm(uint64_t at, Task *task, irq_fn fn, void *arg)
+{
+    uint64_t key = next_key++;
+    Timer timer = { at, task, fn, arg };
+    timers[key] = timer;
+    timeline.insert(std::make_pair(at, key));
+    return key;
+}
+
+static void disarm(uint64_t key)
+{
+    std::map<uint64_t, Timer>::iterator it = timers.find(key);
+    if (it == timers.end())
+        return;
+    timeline.erase(std::make_pair(it->second.at, key));
+    timers.erase(it);
+}
+
+static void unpark(Task *task)
+{
+    if (task->queue)
+    {
+        std::deque<Task*>::iterator it =
+            std::find(task->queue->begin(), task->queue->end(), task);
+        if (it != task->queue->end())
+            task->queue->erase(it);
+        task->queue = NULL;
+    }
+    if (task->timer_key)
+    {
+        disarm(task->timer_key);
+        task->timer_key = 0;
+    }
+}
+
+/*  Fire the earliest timed event */
+//  @brief  advances the clock to it and either wakes the task
+//          (timeout) or runs the interrupt callback
+static void fire_next()
+{
+    uint64_t key = timeline.begin()->second;
+    Timer timer = timers[key];
+    timeline.erase(timeline.begin());
+    timers.erase(key);
+
+    if (timer.at > clock_us)
+        clock_us = timer.at;
+
+    if (timer.task)
+    {
+        Task *task = timer.task;
+        task->timer_key = 0;
+        task->timed_out = true;
+        unpark(task);
+        task->state = Task::READY;
+        level(task).push_back(task);
+        stats.wakeups++;
+    }
+    else
+    {
+        irq_active = true;
+        timer.fn(timer.arg);
+        irq_active = false;
+        stats.irqs++;
+    }
+}
+
+/*  Dispatcher */
+//  @brief  switches to the highest priority ready task, idling the
+//          clock forward while nothing is ready
+static void dispatch()
+{
+    Task *prev = running;
+    Task *next;
+
+    while ((next = pop_ready()) == NULL)
+    {
+        if (timeline.empty())
+        {
+            fprintf(stderr, "sim: all tasks blocked forever at %llu us\n",
+                    (unsigned long long)clock_us);
+            exit(1);
+        }
+        fire_next();
+    }
+
+    next->state = Task::RUNNING;
+    if (next == prev)
+        return;
+
+    stats.context_switches++;
+    running = next;
+    swapcontext(&prev->ctx, &next->ctx);
+}
+
+/*  Preemption check */
+//  @brief  gives the CPU away if a higher priority task became ready
+static void preempt(bool front)
+{
+    if (irq_active || top_ready_priority() <= running->priority)
+        return;
+    running->state = Task::READY;
+    if (front)
+        level(running).push_front(running);
+    else
+        level(running).push_back(running);
+    dispatch();
+}
+
+/*  Task entry point */
+static void trampoline()
+{
+    Task *self = running;
+    self->fn(self->arg);
+    self->state = Task::INACTIVE;
+    dispatch();
+}
+
+uint64_t now_us()
+{
+    return clock_us;
+}
+
+Task *current()
+{
+    init();
+    return running;
+}
+
+bool in_irq()
+{
+    return irq_active;
+}
+
+Task *create(void (*fn)(void const *), void *arg, int priority, uint32_t stack_size)
+{
+    init();
+
+    Task *task = new Task();
+    task->stack = (char*)malloc(HOST_STACK_SIZE);
+    for (uint32_t i = 0; i < HOST_STACK_SIZE / 4; i++)
+        ((uint32_t*)task->stack)[i] = STACK_FILL;
+    task->stack_size = stack_size;
+    task->fn = fn;
+    task->arg = arg;
+    task->priority = priority;
+
+    getcontext(&task->ctx);
+    task->ctx.uc_stack.ss_sp = task->stack;
+    task->ctx.uc_stack.ss_size = HOST_STACK_SIZE;
+    task->ctx.uc_link = NULL;
+    makecontext(&task->ctx, trampoline, 0);
+
+    task->state = Task::READY;
+    level(task).push_back(task);
+    preempt(false);
+    return task;
+}
+
+/*  Deepest host stack use */
+//  @return bytes from the top of the host stack down to the deepest word
+//          written, 0 for the main() context
+//
+//  N.B.: host frames, larger than the same code uses on target
+uint32_t stack_used(Task *task)
+{
+    if (!task->stack)
+        return 0;
+    const uint32_t *words = (const uint32_t*)task->stack;
+    uint32_t i = 0;
+    while (i < HOST_STACK_SIZE / 4 && words[i] == STACK_FILL)
+        i++;
+    return HOST_STACK_SIZE - i * 4;
+}
+
+void wake(Task *task)
+{
+    if (task->state == Task::READY || task->state == Task::RUNNING ||
+        task->state == Task::INACTIVE)
+        return;
+
+    unpark(task);
+    task->timed_out = false;
+    task->state = Task::READY;
+    level(task).push_back(task);
+    stats.wakeups++;
+    preempt(false);
+}
+
+void terminate(Task *task)
+{
+    if (task->state == Task::INACTIVE)
+        return;
+
+    unpark(task);
+    if (task->state == Task::READY)
+    {
+        std::deque<Task*> &queue = level(task);
+        queue.erase(std::find(queue.begin(), queue.end(), task));
+    }
+    bool self = (task == running);
+    task->state = Task::INACTIVE;
+    if (self)
+        dispatch();
+}
+
+void set_priority(Task *task, int priority)
+{
+    if (task->state == Task::READY)
+    {
+        std::deque<Task*> &queue = level(task);
+        queue.erase(std::find(queue.begin(), queue.end(), task));
+        task->priority = priority;
+        level(task).push_back(task);
+    }
+    else
+        task->priority = priority;
+    if (task == running || task->state == Task::READY)
+        preempt(false);
+}
+
+bool block(Task::State state, uint32_t timeout_ms)
+{
+    init();
+
+    Task *self = running;
+    self->state = state;
+    self->timed_out = false;
+    if (timeout_ms != osWaitForever)
+        self->timer_key = arm(clock_us + (uint64_t)timeout_ms * 1000, self, NULL, NULL);
+    dispatch();
+    return !self->timed_out;
+}
+
+void block_until(Task::State state, uint64_t at_us)
+{
+    init();
+
+    Task *self = running;
+    self->state = state;
+    self->timed_out = false;
+    self->timer_key = arm(at_us, self, NULL, NULL);
+    dispatch();
+}
+
+void yield()
+{
+    init();
+    running->state = Task::READY;
+    level(running).push_back(running);
+    dispatch();
+}
+
+void busy(uint64_t us)
+{
+    init();
+
+    uint64_t end = clock_us + us;
+    stats.busy_us += us;
+
+    while (!irq_masked && !timeline.empty() && timeline.begin()->first <= end)
+    {
+        fire_next();
+        preempt(true);
+    }
+    if (end > clock_us)
+        clock_us = end;
+}
+
+uint64_t schedule_irq(uint64_t at_us, irq_fn fn, void *arg)
+{
+    return arm(at_us, NULL, fn, arg);
+}
+
+void cancel_irq(uint64_t handle)
+{
+    disarm(handle);
+}
+
+void irq_mask(bool masked)
+{
+    irq_masked = masked;
+}
+
+void run_for(double seconds)
+{
+    init();
+
+    Task *self = running;
+    self->state = Task::DELAY;
+    self->timed_out = false;
+    self->timer_key = arm(clock_us + (uint64_t)(seconds * 1e6), self, NULL, NULL);
+    dispatch();
+}
+
+}
@@ -0,0 +1,1238 @@
+//************************************************************************
+//
+//  main.cpp (host build)
+//
+//  Runs the Controller on the simulated WattBob board in virtual time.
+//
+//  Usage:  carsim [-t seconds] [-a accelerator] [-b brake] [-n noise] [-v]
+//          carsim -s steps
+//          carsim -f vehicles [-s steps]
+//          carsim -m samples
+//          carsim -e records
+//          carsim -p fields
+//          carsim -k presses
+//          carsim -o seconds [-n noise]
+//          carsim -c ticks
+//          carsim -i seconds
+//          carsim -q rounds
+//          carsim -w ticks
+//
+//          -t  simulated driving time in seconds     (default 3600)
+//          -a  accelerator pedal position, 0.0 - 1.0 (default 0.6)
+//          -b  brake pedal position, 0.0 - 1.0       (default 0.1)
+//          -n  gaussian noise on every ADC conversion, as a fraction
+//              of full scale                         (default 0.02)
+//          -v  print the telemetry records decoded from the serial link
+//          -s  batch mode: replay a 30 minute drive cycle through
+//              Car::replay for the given number of 20Hz steps, without
+//              the RTOS, and report the step rate
+//          -f  fleet mode: drive the given number of vehicles through
+//              CarFleet, each one on the drive cycle shifted by its index,
+//              for the given steps (default one hour) and report the
+//              vehicle step rate
+//          -m  averager benchmark: feed the given number of speed samples
+//              through the former std::queue speed_history path and
+//              through MovingAverage, in window and exponential mode
+//          -e  telemetry benchmark: encode and decode the given number of
+//              records in frames, sampling times included, compare the
+//              wire size with the former CSV lines, and check that a
+//              frame right after a false sync word is still decoded
+//          -p  formatting benchmark: format the given number of integer
+//              fields with Stream::printf and with FixedField
+//          -k  button benchmark: press the WattBob buttons (GPB0-3) the
+//              given number of times, detect them once by polling GPIO
+//              at 10Hz and once through INTA and MCP23017::service(),
+//              and compare I2C transactions and detection latency
+//          -o  pedal benchmark: sample the accelerator of the drive
+//              cycle for the given seconds at PEDAL_SAMPLE_HZ, with noise,
+//              and compare the single conversion per 10Hz update with
+//              PedalFilter: error against the clean pedal and CPU cost
+//          -c  pedal scaling benchmark: time the given number of
+//              updateCommands ticks through the former float scaling and
+//              the read_u16 integer path (see pedalbench.h), in host ns,
+//              and compare both over the 4096 codes of the LPC1768 ADC
+//          -i  tickless idle model: run the RTX delay list of the periodic
+//              threads for the given seconds on a 96MHz SysTick: spinning
+//              idle, WFI between ticks, and the rtos_idle.c tickless loop,
+//              with and without the pedal Ticker, and compare interrupts,
+//              wake-ups, time awake and release accuracy
+//          -q  ready list benchmark: wake up and dispatch 8 to 64 tasks
+//              the given number of rounds through the linear RTX ready
+//              list and through its priority index (rt_RdyMap.h), with
+//              all tasks on one priority and spread over the seven
+//              CMSIS priorities
+//          -w  delay list benchmark: run the given number of system ticks
+//              with 16 to 1024 sleeping tasks and as many periodic timers
+//              through the delta sorted RTX delay chains and through the
+//              timing wheels of rt_DlyWheel.h
+//          -g  integrator benchmark: replay the drive cycle for the given
+//              number of 20Hz steps through the former double precision,
+//              truncating Car update and through physicsSpeed and
+//              physicsDistance, and compare time per step and distance
+//              drift against an exact double integral
+//          -x  executive load: run a schedule of steps that busy wait on
+//              the virtual clock for the given seconds, one of them far
+//              past its frame every tenth run, and print the jitter,
+//              execution time, CPU and overrun figures of the executive
+//
+//  The engine switch is turned on after one second, with the sidelights;
+//  the left indicator is on from 60 s to 90 s. Every switch bounces for
+//  about a millisecond before it settles. 15 s before the end a 'P' and
+//  an 'S' are sent down the serial line, and the profiler and stack
+//  tables the Controller answers with are printed with the other
+//  results. Stack use there is measured on the host stacks, x86-64
+//  frames and the simulated kernel included, so it errs on the large
+//  side; a soak run on the board gives the target figures.
+//  At the end the LCD contents, the executive schedule and the kernel/bus
+//  statistics are printed together with the wall-clock time the run took.
+//  The odometer wraps at 1000 km, about 3925 s at the default pedals: a
+//  -t 4000 run shows the wrapped digits and checks the label after them.
+//
+//************************************************************************
+
+/* Class includes */
+#include "controller.h"
+#include "fleet.h"
+#include "average.h"
+#include "telemetry.h"
+#include "format.h"
+#include "pedals.h"
+#include "pedalbench.h"
+#include "cycles.h"
+
+/* Tickless idle arithmetic, as used by rtos_idle.c on target */
+#include "../mbed-rtos/rtos/rtos_tickless.h"
+
+/* Benchmark includes */
+#include "rdybench.h"
+#include "dlybench.h"
+
+/* Simulator includes */
+#include "sim.h"
+
+/* Standard includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <map>
+#include <queue>
+#include <string>
+
+/* Pedal pins, as in pinout.h */
+#define ACCELERATOR     p17
+#define BRAKE           p16
+
+/* WattBob board */
+static sim::Hd44780 display;
+static sim::Mcp23017 expander(0x40, &display);
+
+/* Far end of the serial link */
+static TelemetryDecoder receiver;
+static bool verbose;
+
+/* Text answer to the console request, collected between frames */
+static bool console_open;
+static std::string console;
+
+static void receive(int c)
+{
+    if (console_open && (c == '\r' || c == '\n' || (c >= ' ' && c < 0x7F)))
+        console += (char)c;
+    if (!receiver.push((uint8_t)c) || !verbose)
+        return;
+    for (uint32_t i = 0; i < receiver.getCount(); i++)
+    {
+        const message &m = receiver.getRecord(i);
+        printf("[%3u] %10u ms  %10u ms  %03u,%03u,%03u\n", receiver.getSequence(),
+               receiver.getTimestamp(), m.time, (unsigned char)m.speed,
+               (unsigned char)m.accelerator, (unsigned char)m.brake);
+    }
+}
+
+static double wall_clock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*  Drive cycle */
+//  @brief  1Hz pedal samples: stop-and-go city traffic, then a faster
+//          rural leg, then a motorway leg, then coming to rest
+static const uint32_t CYCLE_SECONDS = 1800;
+
+static void build_cycle(PedalSample *cycle)
+{
+    for (uint32_t t = 0; t < CYCLE_SECONDS; t++)
+    {
+        uint32_t phase = t % 120;
+        unsigned char push = t < 600 ? 90 : (t < 1200 ? 140 : 200);
+
+        if (t >= 1700)
+        {
+            cycle[t].accelerator = 0;
+            cycle[t].brake = 60;
+        }
+        else if (phase < 60)
+        {
+            cycle[t].accelerator = push;
+            cycle[t].brake = 0;
+        }
+        else if (phase < 100)
+        {
+            cycle[t].accelerator = push / 3;
+            cycle[t].brake = 0;
+        }
+        else
+        {
+            cycle[t].accelerator = 0;
+            cycle[t].brake = t < 600 ? 120 : 40;
+        }
+    }
+}
+
+/*  Former Car::updateSpeed step */
+//  @brief  double arithmetic truncated to the char speed and the whole
+//          metre distance every tick; a negative speed converts to 0, as
+//          __aeabi_d2uiz does on target. Distance is 32-bit here, the
+//          former unsigned short wrapped at 65535 m
+static inline void legacyStep(unsigned char &speed, uint32_t &distance,
+                              unsigned char acc, unsigned char brake)
+{
+    double next = speed + ((acc - brake) * 0.05);
+    unsigned short test = next < 0 ? 0 : (unsigned short)next;
+    if (test < 255)
+        speed = test;
+    else
+        speed = 255;
+    distance = distance + (speed * 0.05);
+}
+
+/*  Integrator benchmark */
+static int integrator(uint64_t steps)
+{
+    static PedalSample cycle[CYCLE_SECONDS];
+    const uint32_t ticks = 20;
+    build_cycle(cycle);
+
+    uint32_t samples = steps / ticks;
+    volatile uint32_t sink;
+
+    // Exact integral of the same model, the reference for both paths
+    double exact_speed = 0, exact_distance = 0;
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        const PedalSample &s = cycle[i % CYCLE_SECONDS];
+        for (uint32_t t = 0; t < ticks; t++)
+        {
+            exact_speed += (s.accelerator - s.brake) * 0.05;
+            exact_speed = exact_speed < 0 ? 0 : (exact_speed > 255 ? 255 : exact_speed);
+            exact_distance += exact_speed * 0.05;
+        }
+    }
+
+    unsigned char legacy_speed = 0;
+    uint32_t legacy_distance = 0;
+    double start = wall_clock();
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        const PedalSample &s = cycle[i % CYCLE_SECONDS];
+        for (uint32_t t = 0; t < ticks; t++)
+            legacyStep(legacy_speed, legacy_distance, s.accelerator, s.brake);
+    }
+    double legacy_wall = wall_clock() - start;
+    sink = legacy_distance;
+
+    int32_t speed = 0;
+    uint32_t distance = 0, frac = 0;
+    start = wall_clock();
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        const PedalSample &s = cycle[i % CYCLE_SECONDS];
+        for (uint32_t t = 0; t < ticks; t++)
+        {
+            speed = physicsSpeed(speed, s.accelerator, s.brake, PHYSICS_DT);
+            physicsDistance(distance, frac, speed, PHYSICS_DT);
+        }
+    }
+    double fixed_wall = wall_clock() - start;
+    sink = distance;
+    (void)sink;
+
+    double done = (double)samples * ticks;
+    double fixed_distance = distance + (double)frac / PHYSICS_ONE;
+    printf("integrator      %.0f steps (%.1f h at 20Hz), Q%d, exact %.1f m\n",
+           done, done / 20.0 / 3600.0, PHYSICS_FRAC_BITS, exact_distance);
+    printf("  %-12s %10s %12s %12s %10s\n", "path", "ns/step", "distance m", "drift m", "drift %");
+    printf("  %-12s %10.2f %12u %12.1f %10.3f\n", "double", legacy_wall / done * 1e9,
+           legacy_distance, legacy_distance - exact_distance,
+           exact_distance > 0 ? 100.0 * (legacy_distance - exact_distance) / exact_distance : 0.0);
+    printf("  %-12s %10.2f %12.1f %12.1f %10.3f\n", "fixed", fixed_wall / done * 1e9,
+           fixed_distance, fixed_distance - exact_distance,
+           exact_distance > 0 ? 100.0 * (fixed_distance - exact_distance) / exact_distance : 0.0);
+    printf("  host has an FPU: the double path costs far more on the Cortex-M3\n");
+    fflush(stdout);
+    _exit(0);
+}
+
+static int batch(uint64_t steps)
+{
+    static PedalSample cycle[CYCLE_SECONDS];
+    const uint32_t ticks = 20;
+    build_cycle(cycle);
+
+    Car car;
+    car.TurnOn();
+
+    double start = wall_clock();
+    uint64_t done = 0;
+    while (done < steps)
+    {
+        uint64_t left = (steps - done) / ticks;
+        uint32_t samples = left < CYCLE_SECONDS ? (uint32_t)left : CYCLE_SECONDS;
+        if (samples == 0)
+            break;
+        car.replay(cycle, samples, ticks, PHYSICS_DT);
+        done += (uint64_t)samples * ticks;
+    }
+    double wall = wall_clock() - start;
+
+    printf("steps           %llu (%.1f h at 20Hz)\n", (unsigned long long)done,
+           done / 20.0 / 3600.0);
+    printf("distance        %d m, speed %d\n", car.getDistance(), (unsigned char)car.getSpeed());
+    printf("wall time       %.3f s, %.1f Msteps/s\n", wall,
+           wall > 0 ? done / wall / 1e6 : 0.0);
+    fflush(stdout);
+    _exit(0);
+}
+
+static int fleet(uint32_t vehicles, uint64_t steps)
+{
+    static PedalSample cycle[CYCLE_SECONDS];
+    const uint32_t ticks = 20;
+    build_cycle(cycle);
+
+    CarFleet cars(vehicles);
+    for (uint32_t i = 0; i < vehicles; i++)
+        cars.TurnOn(i);
+
+    double start = wall_clock();
+    uint64_t done = 0;
+    for (uint32_t t = 0; done + ticks <= steps; t++)
+    {
+        for (uint32_t i = 0; i < vehicles; i++)
+        {
+            const PedalSample &sample = cycle[(t + i) % CYCLE_SECONDS];
+            cars.writeAcc(i, sample.accelerator);
+            cars.writeBrake(i, sample.brake);
+        }
+        cars.run(ticks, PHYSICS_DT);
+        done += ticks;
+    }
+    double wall = wall_clock() - start;
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < vehicles; i++)
+        total += cars.getDistance(i);
+
+    printf("vehicles        %u\n", vehicles);
+    printf("steps           %llu (%.1f h at 20Hz)\n", (unsigned long long)done,
+           done / 20.0 / 3600.0);
+    printf("distance        %llu m total, %llu m average\n", (unsigned long long)total,
+           (unsigned long long)(vehicles ? total / vehicles : 0));
+    printf("wall time       %.3f s, %.1f M vehicle steps/s\n", wall,
+           wall > 0 ? done * vehicles / wall / 1e6 : 0.0);
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Former Controller::getAverage */
+//  @brief  averages disjoint triplets once four samples are queued
+static unsigned char queue_average(std::queue<char> &history, unsigned char &average)
+{
+    if (history.size() < 4)
+        return average;
+    char one = history.front();
+    history.pop();
+    char two = history.front();
+    history.pop();
+    char three = history.front();
+    history.pop();
+    average = (one + two + three) / 3;
+    return average;
+}
+
+static void report_average(const char *name, double wall, uint64_t samples, uint64_t check)
+{
+    printf("  %-12s %8.2f ns/sample   checksum %llu\n", name,
+           samples ? wall * 1e9 / samples : 0.0, (unsigned long long)check);
+}
+
+// N.B.: length must be a power of two
+static void bench_queue(const unsigned char *input, uint32_t length, uint64_t samples)
+{
+    std::queue<char> history;
+    unsigned char average = 0;
+    uint64_t check = 0;
+
+    double start = wall_clock();
+    for (uint64_t i = 0; i < samples; i++)
+    {
+        history.push(input[i & (length - 1)]);
+        check += queue_average(history, average);
+    }
+    report_average("queue", wall_clock() - start, samples, check);
+}
+
+// N.B.: length must be a power of two
+static void bench_filter(const char *name, AverageMode mode,
+                         const unsigned char *input, uint32_t length, uint64_t samples)
+{
+    MovingAverage<SPEED_WINDOW> filter(mode);
+    uint64_t check = 0;
+
+    double start = wall_clock();
+    for (uint64_t i = 0; i < samples; i++)
+        check += filter.update(input[i & (length - 1)]);
+    report_average(name, wall_clock() - start, samples, check);
+}
+
+static int averager(uint64_t samples)
+{
+    static unsigned char input[4096];
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < sizeof(input); i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        input[i] = (unsigned char)(60 + ((seed >> 16) % 32));
+    }
+
+    printf("averager        %llu samples, window %u\n", (unsigned long long)samples,
+           SPEED_WINDOW);
+    bench_queue(input, sizeof(input), samples);
+    bench_filter("window", AVERAGE_WINDOW, input, sizeof(input), samples);
+    bench_filter("exponential", AVERAGE_EXPONENTIAL, input, sizeof(input), samples);
+    fflush(stdout);
+    _exit(0);
+}
+
+static int telemetry(uint64_t records)
+{
+    static PedalSample cycle[CYCLE_SECONDS];
+    build_cycle(cycle);
+
+    TelemetryEncoder encoder;
+    TelemetryDecoder decoder;
+    uint64_t frame_bytes = 0, csv_bytes = 0, decoded = 0, mismatches = 0;
+    char line[32];
+
+    // Speed follows the pedals loosely, as the 5s samples of a drive would
+    message m;
+    int speed = 0;
+    message sent[TELEMETRY_MAX_RECORDS];
+
+    double start = wall_clock();
+    for (uint64_t done = 0; done < records; )
+    {
+        encoder.begin((uint32_t)(done + TELEMETRY_MAX_RECORDS) * 5000);
+        uint32_t n = 0;
+        while (n < TELEMETRY_MAX_RECORDS && done < records)
+        {
+            const PedalSample &p = cycle[done % CYCLE_SECONDS];
+            speed += (p.accelerator - p.brake) / 8;
+            speed = speed < 0 ? 0 : (speed > 255 ? 255 : speed);
+            m.speed = speed;
+            m.accelerator = p.accelerator;
+            m.brake = p.brake;
+            m.time = (uint32_t)done * 5000;
+            encoder.add(m);
+            sent[n++] = m;
+            csv_bytes += snprintf(line, sizeof(line), "%03i,%03i,%03i\r\n", speed,
+                                  p.accelerator, p.brake);
+            done++;
+        }
+
+        uint32_t length = encoder.finish();
+        const uint8_t *frame = encoder.data();
+        frame_bytes += length;
+        for (uint32_t i = 0; i < length; i++)
+        {
+            if (!decoder.push(frame[i]))
+                continue;
+            for (uint32_t j = 0; j < decoder.getCount(); j++)
+            {
+                const message &r = decoder.getRecord(j);
+                mismatches += r.speed != sent[j].speed || r.accelerator != sent[j].accelerator ||
+                              r.brake != sent[j].brake || r.time != sent[j].time;
+            }
+            decoded += decoder.getCount();
+        }
+    }
+    double wall = wall_clock() - start;
+
+    /* A false sync word claiming a long frame, right before a real one:
+       the real frame has to be found inside the claimed length */
+    TelemetryDecoder resync;
+    static const uint8_t false_sync[] = { TELEMETRY_SYNC0, TELEMETRY_SYNC1, 0, 1, 0, 0, 0, 0, 100, 0 };
+    for (uint32_t i = 0; i < sizeof(false_sync); i++)
+        resync.push(false_sync[i]);
+    encoder.begin(0);
+    encoder.add(m);
+    uint32_t length = encoder.finish();
+    for (uint32_t i = 0; i < length; i++)
+        resync.push(encoder.data()[i]);
+    for (uint32_t i = 0; i < 100; i++)
+        resync.push(0);
+
+    printf("records         %llu, %llu decoded, %llu mismatches, %u errors\n",
+           (unsigned long long)records, (unsigned long long)decoded,
+           (unsigned long long)mismatches, decoder.getErrors());
+    printf("resync          frame after a false sync %s, %u errors\n",
+           resync.getFrames() == 1 ? "decoded" : "LOST", resync.getErrors());
+    printf("wire bytes      frames %llu (%.2f/record), csv %llu (%.2f/record), x%.1f\n",
+           (unsigned long long)frame_bytes, records ? (double)frame_bytes / records : 0.0,
+           (unsigned long long)csv_bytes, records ? (double)csv_bytes / records : 0.0,
+           frame_bytes ? (double)csv_bytes / frame_bytes : 0.0);
+    printf("115200 baud     %.0f records/s framed, %.0f records/s csv\n",
+           frame_bytes ? 11520.0 * records / frame_bytes : 0.0,
+           csv_bytes ? 11520.0 * records / csv_bytes : 0.0);
+    printf("wall time       %.3f s, %.1f ns/record (encode, csv, decode)\n", wall,
+           records ? wall * 1e9 / records : 0.0);
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Stream with no device behind it */
+class NullStream : public Stream
+{
+    public:
+        uint64_t count;
+        NullStream() : count(0) {}
+    protected:
+        virtual int _putc(int c) { count++; return c; }
+        virtual int _getc() { return -1; }
+};
+
+static int formatter(uint64_t fields)
+{
+    NullStream stream;
+    char text[FixedField<6>::SIZE];
+
+    double start = wall_clock();
+    for (uint64_t i = 0; i < fields; i++)
+        stream.printf("%06i", (int)(i & 0xFFFFF));
+    double printf_wall = wall_clock() - start;
+    uint64_t printf_chars = stream.count;
+
+    stream.count = 0;
+    start = wall_clock();
+    for (uint64_t i = 0; i < fields; i++)
+    {
+        int length = FixedField<6>::format(text, (int32_t)(i & 0xFFFFF));
+        for (int j = 0; j < length; j++)
+            stream.putc(text[j]);
+    }
+    double fixed_wall = wall_clock() - start;
+
+    printf("fields          %llu, %llu / %llu characters\n", (unsigned long long)fields,
+           (unsigned long long)printf_chars, (unsigned long long)stream.count);
+    printf("  %-12s %8.2f ns/field\n", "printf", fields ? printf_wall * 1e9 / fields : 0.0);
+    printf("  %-12s %8.2f ns/field\n", "FixedField", fields ? fixed_wall * 1e9 / fields : 0.0);
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Error of an 8-bit pedal reading against the clean level */
+struct PedalError
+{
+    double squares;
+    int worst;
+    uint32_t count;
+
+    void add(int value, int clean)
+    {
+        int error = value > clean ? value - clean : clean - value;
+        squares += (double)error * error;
+        if (error > worst)
+            worst = error;
+        count++;
+    }
+};
+
+static int pedals(uint32_t seconds, float noise)
+{
+    const uint32_t per_update = PEDAL_SAMPLE_HZ / 10;
+    PedalSample *cycle = new PedalSample[CYCLE_SECONDS];
+    build_cycle(cycle);
+
+    // Noisy conversions through the simulated ADC
+    uint32_t length = seconds * PEDAL_SAMPLE_HZ;
+    uint16_t *raw = new uint16_t[length];
+    uint8_t *clean = new uint8_t[length];
+    AnalogIn pin(ACCELERATOR);
+    sim::set_analog_noise(noise);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        clean[i] = cycle[(i / PEDAL_SAMPLE_HZ) % CYCLE_SECONDS].accelerator;
+        sim::set_analog(ACCELERATOR, clean[i] / 255.0f);
+        raw[i] = pin.read_u16();
+    }
+
+    // Former path: one conversion per update, scaled as a float
+    PedalError single = PedalError();
+    double start = wall_clock();
+    for (uint32_t i = per_update - 1; i < length; i += per_update)
+        single.add((int)(raw[i] / 65535.0f * 255), clean[i]);
+    double single_wall = wall_clock() - start;
+
+    // Every conversion through the filter, read at the updates; the
+    // first second is the filter settling and is not scored
+    PedalFilter filter;
+    PedalError filtered = PedalError();
+    uint8_t *updates = new uint8_t[length / per_update + 1];
+    start = wall_clock();
+    for (uint32_t i = 0; i < length; i++)
+    {
+        filter.sample(raw[i] >> 4);
+        if (i % per_update == per_update - 1)
+            updates[i / per_update] = filter.value();
+    }
+    double filter_wall = wall_clock() - start;
+    for (uint32_t i = PEDAL_SAMPLE_HZ + per_update - 1; i < length; i += per_update)
+        filtered.add(updates[i / per_update], clean[i]);
+
+    double filter_ns = length ? filter_wall * 1e9 / length : 0.0;
+    printf("pedals          %u s, %u samples at %u Hz, noise %.3f of full scale\n",
+           seconds, length, PEDAL_SAMPLE_HZ, noise);
+    printf("  %-12s %10s %10s %12s\n", "path", "rms error", "max error", "ns/sample");
+    printf("  %-12s %10.2f %10d %12.2f\n", "single",
+           single.count ? sqrt(single.squares / single.count) : 0.0, single.worst,
+           single.count ? single_wall * 1e9 / single.count : 0.0);
+    printf("  %-12s %10.2f %10d %12.2f\n", "filtered",
+           filtered.count ? sqrt(filtered.squares / filtered.count) : 0.0, filtered.worst,
+           filter_ns);
+    printf("  filter load   %.4f%% of one host core for two channels\n",
+           filter_ns * 2 * PEDAL_SAMPLE_HZ / 1e7);
+    fflush(stdout);
+    _exit(0);
+}
+
+static int scaling(uint32_t ticks)
+{
+    AnalogIn accelerator(ACCELERATOR);
+    AnalogIn brake(BRAKE);
+    PedalBenchmark result;
+
+    sim::set_analog(ACCELERATOR, 0.6f);
+    sim::set_analog(BRAKE, 0.1f);
+    benchmarkPedals(accelerator, brake, ticks, result);
+
+    printf("pedal scaling   %u ticks, " CYCLES_UNIT " per tick, %u ticks off by one count\n",
+           result.ticks, result.mismatches);
+    printf("  %-12s %10s %10s\n", "path", "avg", "min");
+    printf("  %-12s %10.1f %10u\n", "float", (double)result.float_total / result.ticks,
+           result.float_min);
+    printf("  %-12s %10.1f %10u\n", "integer", (double)result.integer_total / result.ticks,
+           result.integer_min);
+
+    PedalSweep sweep;
+    sweepPedalCodes(sweep);
+    printf("  LPC1768 codes %u, %u differ (%u integer higher), by %u count at most\n",
+           sweep.codes, sweep.mismatches, sweep.integer_higher, sweep.max_difference);
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Ready list benchmark */
+static int readylist(uint32_t rounds)
+{
+    static const uint32_t counts[] = { 8, 12, 16, 32, 64 };
+    static const uint32_t levels[] = { 1, 7 };
+
+    printf("ready list      host ns per operation, linear walk / priority index\n");
+    printf("  %5s %6s %8s %17s %17s %17s %6s\n", "tasks", "prios", "rounds",
+           "wake-up", "dispatch", "requeue", "diff");
+    for (int l = 0; l < 2; l++)
+        for (int c = 0; c < 5; c++)
+        {
+            ReadyBenchmark r;
+            benchmarkReadyList(counts[c], levels[l], rounds, &r);
+            printf("  %5u %6u %8u %8.2f /%7.2f %8.2f /%7.2f %8.2f /%7.2f %6u\n",
+                   r.tasks, r.levels, r.rounds, r.linear_put, r.map_put,
+                   r.linear_get, r.map_get, r.linear_requeue, r.map_requeue,
+                   r.mismatches);
+        }
+    fflush(stdout);
+    _exit(0);
+}
+
+/* Executive load: busy time of each step, in us */
+static const int LOAD_FAST_US = 10000;
+static const int LOAD_MEDIUM_US = 30000;
+static const int LOAD_BURST_US = 5000;
+static const int LOAD_OVERRUN_US = 250000;
+
+/*  Step costing its argument in virtual time */
+static void loadStep(void const *p)
+{
+    wait_us((int)(intptr_t)p);
+}
+
+/*  Step overrunning its frame every tenth run */
+static void burstStep(void const *p)
+{
+    uint32_t *runs = (uint32_t*)p;
+    wait_us(++*runs % 10 ? LOAD_BURST_US : LOAD_OVERRUN_US);
+}
+
+/*  Executive load */
+//  @brief  the Controller steps take no virtual time, so its schedule
+//          reports zero jitter and execution time; these steps busy
+//          wait, and the burst step overruns the 100 ms frame
+static int executiveLoad(uint32_t seconds)
+{
+    Executive executive(osPriorityNormal, 2048);
+    uint32_t bursts = 0;
+
+    executive.addTask("fast",   loadStep,  (void*)(intptr_t)LOAD_FAST_US,   100);
+    executive.addTask("medium", loadStep,  (void*)(intptr_t)LOAD_MEDIUM_US, 200);
+    executive.addTask("burst",  burstStep, &bursts,                         1000);
+    executive.start();
+    sim::run_for(seconds);
+
+    printf("executive load  %u s, minor %u ms, major %u ms, %u overruns, cpu %.2f%%\n",
+           seconds, executive.getMinorFrame(), executive.getMajorFrame(),
+           executive.getOverruns(), executive.cpuUsage() * 100.0f);
+    printf("  %-12s %8s %8s %10s %10s %10s %10s\n", "task", "period", "runs",
+           "jitter avg", "jitter max", "exec avg", "exec max");
+    for (int i = 0; i < executive.getTaskCount(); i++)
+    {
+        const TaskStats &t = executive.taskStats(i);
+        printf("  %-12s %8u %8u %10llu %10u %10llu %10u\n", t.name, t.period_ms, t.runs,
+               (unsigned long long)(t.runs ? t.total_jitter / t.runs : 0), t.max_jitter,
+               (unsigned long long)(t.runs ? t.total_exec / t.runs : 0), t.max_exec);
+    }
+    // A burst frame ends at 290 ms; frames 1 to 3 start late and the
+    // grid is caught up by the release at 400 ms: 3 overruns per burst
+    printf("  %u bursts of %d us, %u overruns expected\n",
+           bursts / 10, LOAD_OVERRUN_US, bursts / 10 * 3);
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Delay list benchmark */
+static int delays(uint32_t ticks)
+{
+    static const uint32_t counts[] = { 16, 64, 256, 512, 1024 };
+    DelayBenchmark results[5];
+
+    for (int c = 0; c < 5; c++)
+        benchmarkDelays(counts[c], counts[c], ticks, &results[c]);
+
+    printf("delay list      host ns per tick, delta chain / timing wheel (%u slots)\n",
+           results[0].slots);
+    printf("  %5s %6s %8s %10s %10s %17s %6s\n", "tasks", "timers", "ticks",
+           "released", "put", "tick", "diff");
+    for (int c = 0; c < 5; c++)
+    {
+        const DelayBenchmark &r = results[c];
+        printf("  %5u %6u %8u %10llu %10llu %8.1f /%7.1f %6u\n",
+               r.tasks, r.timers, r.ticks, (unsigned long long)r.releases,
+               (unsigned long long)r.inserts, r.chain, r.wheel, r.mismatches);
+    }
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Tickless idle model */
+//  @brief  the RTX delay list of the periodic threads (car 50ms, executive
+//          100ms) on a 96MHz SysTick, once ticking every OS_TICK and once
+//          through the rtos_idle.c tickless loop and its rtos_tickless.h
+//          arithmetic, optionally with the 1600Hz pedal Ticker interrupt
+//
+//  N.B.:   interrupt and reprogramming costs are round estimates, the
+//          counts and the release accuracy are exact
+static const uint64_t MODEL_TICK = 96000;          // cycles per 1ms tick
+static const uint64_t MODEL_GUARD = 1024;          // TICKLESS_GUARD
+static const uint64_t MODEL_ISR = 500;             // interrupt entry to exit
+static const uint64_t MODEL_RESUME = 500;          // tick reprogram, resume call
+static const uint64_t MODEL_EXEC = 2000;           // one thread release
+static const uint64_t MODEL_TICKER = 96000000 / PEDAL_SAMPLE_HZ;
+static const uint64_t MODEL_NEVER = ~0ULL;
+static const uint32_t MODEL_PERIODS[] = { 50, 100 };
+static const int MODEL_THREADS = sizeof(MODEL_PERIODS) / sizeof(MODEL_PERIODS[0]);
+
+struct ModelResult
+{
+    uint64_t os_time;
+    uint64_t systick;           // SysTick interrupts taken
+    uint64_t external;          // pedal Ticker interrupts
+    uint64_t wakeups;           // WFI exits
+    uint64_t sleeps;            // stretched ticks
+    uint64_t early;             // stretched ticks ended by the Ticker
+    uint64_t awake;             // cycles out of WFI
+    uint64_t releases;
+    uint64_t late;              // released on another tick than due
+    uint64_t worst_error;       // due tick boundary to release, cycles
+};
+
+static void model(bool tickless, bool ticker, uint64_t end, ModelResult &r)
+{
+    std::multimap<uint64_t, int> delays;
+    for (int i = 0; i < MODEL_THREADS; i++)
+        delays.insert(std::make_pair((uint64_t)MODEL_PERIODS[i], i));
+
+    uint64_t now = 0;
+    uint64_t boundary = MODEL_TICK;
+    uint64_t next_ext = ticker ? MODEL_TICKER : MODEL_NEVER;
+    r = ModelResult();
+
+    while (now < end)
+    {
+        // A Ticker interrupt that came during a release runs before idle
+        if (next_ext <= now)
+        {
+            r.external++;
+            r.awake += MODEL_ISR;
+            now += MODEL_ISR;
+            next_ext += MODEL_TICKER;
+            continue;
+        }
+
+        uint64_t at;
+        bool external;
+        uint64_t head = delays.begin()->first - r.os_time;
+        uint64_t first = boundary > now ? boundary - now : 0;
+
+        if (!tickless || first < MODEL_GUARD || head < 2)
+        {
+            // Ticking: sleep until the boundary or the Ticker
+            external = next_ext < boundary;
+            at = external ? next_ext : boundary;
+            if (at > now)
+                r.wakeups++;
+            else
+                at = now;
+            if (!external)
+            {
+                r.systick++;
+                r.os_time++;
+                boundary += MODEL_TICK;
+            }
+            now = at + MODEL_ISR;
+            r.awake += MODEL_ISR;
+        }
+        else
+        {
+            // Tickless: one reload across the ticks up to the next expiry
+            uint32_t ticks = head < 0xFFFF ? (uint32_t)head : 0xFFFF;
+            uint32_t limit = tickless_limit((uint32_t)first, MODEL_TICK);
+            if (ticks > limit)
+                ticks = limit;
+            uint32_t cycles = tickless_cycles((uint32_t)first, ticks, MODEL_TICK);
+
+            external = next_ext < now + cycles;
+            uint32_t elapsed = external ? (uint32_t)(next_ext - now) : cycles;
+            uint32_t next;
+            uint32_t passed = tickless_passed((uint32_t)first, elapsed, MODEL_TICK, &next);
+
+            at = now + elapsed;
+            r.sleeps++;
+            r.wakeups++;
+            r.early += external;
+            r.os_time += passed;
+            boundary = at + next;
+            now = at + MODEL_RESUME + (external ? MODEL_ISR : 0);
+            r.awake += now - at;
+        }
+        if (external)
+        {
+            r.external++;
+            next_ext += MODEL_TICKER;
+        }
+
+        // Interval waits that expired on this tick
+        while (delays.begin()->first <= r.os_time)
+        {
+            uint64_t due = delays.begin()->first;
+            int thread = delays.begin()->second;
+            delays.erase(delays.begin());
+
+            uint64_t due_at = due * MODEL_TICK;
+            if (now < due_at || now - due_at >= MODEL_TICK)
+                r.late++;
+            else if (now - due_at > r.worst_error)
+                r.worst_error = now - due_at;
+            r.releases++;
+            now += MODEL_EXEC;
+            r.awake += MODEL_EXEC;
+            delays.insert(std::make_pair(due + MODEL_PERIODS[thread], thread));
+        }
+    }
+}
+
+static int tickless(uint32_t seconds)
+{
+    uint64_t end = (uint64_t)seconds * 1000 * MODEL_TICK;
+
+    printf("tickless        %u s, 1 ms tick, periodic threads at %u and %u ms\n",
+           seconds, MODEL_PERIODS[0], MODEL_PERIODS[1]);
+    printf("  %-10s %-6s %10s %10s %10s %8s %8s %10s %6s\n", "idle", "ticker",
+           "systick/s", "wakeups/s", "releases", "early", "awake %", "error max", "late");
+    static const char *modes[] = { "busy", "wfi", "tickless" };
+    for (int ticker = 0; ticker < 2; ticker++)
+        for (int mode = 0; mode < 3; mode++)
+        {
+            // busy: the former idle loop, spinning with the tick running;
+            // wfi: sleep() between ticks; tickless: rtos_idle.c
+            ModelResult r;
+            model(mode == 2, ticker != 0, end, r);
+            if (mode == 0)
+            {
+                r.wakeups = 0;
+                r.awake = end;
+            }
+            printf("  %-10s %-6s %10.1f %10.1f %10llu %8llu %8.3f %7llu cy %6llu\n",
+                   modes[mode], ticker ? "on" : "off",
+                   (double)r.systick / seconds, (double)r.wakeups / seconds,
+                   (unsigned long long)r.releases, (unsigned long long)r.early,
+                   100.0 * r.awake / end, (unsigned long long)r.worst_error,
+                   (unsigned long long)r.late);
+        }
+    fflush(stdout);
+    _exit(0);
+}
+
+/*  Switch contact: a few transitions within a millisecond, then the level */
+static void settle(void *arg)
+{
+    uintptr_t v = (uintptr_t)arg;
+    sim::set_digital(v >> 1, v & 1);
+}
+
+static void flip(int pin, int level, double at)
+{
+    uint64_t t = (uint64_t)(at * 1e6);
+    for (int i = 0; i < 4; i++)
+        sim::schedule_irq(t + i * 300, settle, (void*)(uintptr_t)((pin << 1) | ((level ^ i) & 1)));
+    sim::schedule_irq(t + 1200, settle, (void*)(uintptr_t)((pin << 1) | level));
+}
+
+/*  Console request: the profiler and stack dump commands, sent down the line */
+static void request_dumps(void *arg)
+{
+    (void)arg;
+    console_open = true;
+    sim::uart_rx('P');
+    sim::uart_rx('S');
+}
+
+/* Host board: MCP23017 INTA wired to p12 */
+#define EXPANDER_INT    p12
+
+/* Buttons are active low, pulled up and inverted by IPOL */
+static const uint16_t BUTTONS = 0x0F00;
+static const uint64_t PRESS_PERIOD_US = 730000;
+static const uint64_t PRESS_LENGTH_US = 150000;
+
+struct ButtonBench
+{
+    MCP23017 *port;
+    uint64_t pressed_at;
+    uint32_t detected;
+    uint64_t total_latency;
+    uint64_t max_latency;
+};
+
+static ButtonBench bench;
+
+/*  Presses button (n % 4) and releases it PRESS_LENGTH_US later */
+static void press(void *arg)
+{
+    uint32_t n = (uint32_t)(uintptr_t)arg;
+    uint16_t bit = 0x0100 << (n / 2 % 4);
+    bench.pressed_at = sim::now_us();
+    if (n & 1)
+        expander.set_inputs(expander.inputs() | bit);
+    else
+    {
+        expander.set_inputs(expander.inputs() & ~bit);
+        sim::schedule_irq(sim::now_us() + PRESS_LENGTH_US, press, (void*)(uintptr_t)(n + 1));
+    }
+}
+
+static void detect()
+{
+    uint64_t latency = sim::now_us() - bench.pressed_at;
+    bench.detected++;
+    bench.total_latency += latency;
+    if (latency > bench.max_latency)
+        bench.max_latency = latency;
+}
+
+static void pollButtons(void const *p)
+{
+    (void)p;
+    int last = bench.port->read_mask(BUTTONS);
+    while (true)
+    {
+        Thread::wait(100);
+        int now = bench.port->read_mask(BUTTONS);
+        for (int changed = now ^ last; changed; changed &= changed - 1)
+            detect();
+        last = now;
+    }
+}
+
+static void buttonChanged(int pin, int value, void const *arg)
+{
+    (void)pin;
+    (void)value;
+    (void)arg;
+    detect();
+}
+
+static void serviceButtons(void const *p)
+{
+    (void)p;
+    while (true)
+    {
+        Thread::signal_wait(0x1);
+        bench.port->service();
+    }
+}
+
+static void report_buttons(const char *name, uint32_t transactions, double seconds)
+{
+    printf("  %-12s %8u %8u %10.1f %10.1f %10.3f %10.1f\n", name, bench.detected,
+           transactions, bench.detected ? bench.total_latency / 1000.0 / bench.detected : 0.0,
+           bench.max_latency / 1000.0, transactions / seconds,
+           bench.detected ? (double)transactions / bench.detected : 0.0);
+}
+
+static void run_buttons(uint32_t presses)
+{
+    bench.pressed_at = 0;
+    bench.detected = 0;
+    bench.total_latency = 0;
+    bench.max_latency = 0;
+    uint64_t start = sim::now_us() + PRESS_PERIOD_US / 2;
+    for (uint32_t i = 0; i < presses; i++)
+        sim::schedule_irq(start + i * PRESS_PERIOD_US, press, (void*)(uintptr_t)(2 * i));
+}
+
+static int buttons(uint32_t presses)
+{
+    double seconds = presses * PRESS_PERIOD_US / 1e6 + 1.0;
+
+    expander.set_inputs(BUTTONS);
+    expander.connect_int(EXPANDER_INT);
+    MCP23017 port(p9, p10, 0x40);
+    port.config(BUTTONS, BUTTONS, BUTTONS);
+    bench.port = &port;
+
+    printf("buttons         %u presses, %u edges in %.1f s\n", presses, 2 * presses, seconds);
+    printf("  %-12s %8s %8s %10s %10s %10s %10s\n", "mode", "edges", "i2c", "lat avg ms",
+           "lat max ms", "i2c/s", "i2c/edge");
+
+    port.reset_counters();
+    run_buttons(presses);
+    {
+        Thread poller(pollButtons);
+        sim::run_for(seconds);
+    }
+    report_buttons("poll 10Hz", port.get_transactions(), seconds);
+
+    port.interrupt_attach(EXPANDER_INT);
+    port.interrupt_enable(BUTTONS);
+    for (int pin = 8; pin < 12; pin++)
+        port.attach(pin, buttonChanged, NULL);
+    port.reset_counters();
+    run_buttons(presses);
+    {
+        Thread servicer(serviceButtons, NULL, osPriorityAboveNormal);
+        port.signal(&servicer, 0x1);
+        sim::run_for(seconds);
+        port.signal(NULL, 0);
+    }
+    report_buttons("interrupt", port.get_transactions(), seconds);
+    printf("  %u INTA interrupts\n", port.get_interrupts());
+    fflush(stdout);
+    _exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = 3600;
+    float accelerator = 0.6f;
+    float brake = 0.1f;
+    float noise = 0.02f;
+    uint32_t pedal_seconds = 0;
+    uint32_t ticks = 0;
+    uint32_t idle_seconds = 0;
+    uint32_t rounds = 0;
+    uint32_t wheel_ticks = 0;
+    uint32_t load_seconds = 0;
+    uint64_t integrator_steps = 0;
+    uint64_t steps = 0;
+    uint32_t vehicles = 0;
+    uint64_t samples = 0;
+    uint64_t records = 0;
+    uint64_t fields = 0;
+    uint32_t presses = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:a:b:n:vs:f:m:e:p:k:o:c:i:q:w:x:g:")) != -1)
+    {
+        switch (opt)
+        {
+            case 't': seconds = atof(optarg); break;
+            case 'a': accelerator = atof(optarg); break;
+            case 'b': brake = atof(optarg); break;
+            case 'n': noise = atof(optarg); break;
+            case 'v': verbose = true; break;
+            case 's': steps = strtoull(optarg, NULL, 0); break;
+            case 'f': vehicles = strtoul(optarg, NULL, 0); break;
+            case 'm': samples = strtoull(optarg, NULL, 0); break;
+            case 'e': records = strtoull(optarg, NULL, 0); break;
+            case 'p': fields = strtoull(optarg, NULL, 0); break;
+            case 'k': presses = strtoul(optarg, NULL, 0); break;
+            case 'o': pedal_seconds = strtoul(optarg, NULL, 0); break;
+            case 'c': ticks = strtoul(optarg, NULL, 0); break;
+            case 'i': idle_seconds = strtoul(optarg, NULL, 0); break;
+            case 'q': rounds = strtoul(optarg, NULL, 0); break;
+            case 'w': wheel_ticks = strtoul(optarg, NULL, 0); break;
+            case 'x': load_seconds = strtoul(optarg, NULL, 0); break;
+            case 'g': integrator_steps = strtoull(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-t seconds] [-a accel] [-b brake] [-n noise] [-v] | -s steps | -f vehicles [-s steps] | -m samples | -e records | -p fields | -k presses | -o seconds [-n noise] | -c ticks | -i seconds | -q rounds | -w ticks | -x seconds | -g steps\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if (integrator_steps)
+        return integrator(integrator_steps);
+    if (load_seconds)
+        return executiveLoad(load_seconds);
+    if (wheel_ticks)
+        return delays(wheel_ticks);
+    if (rounds)
+        return readylist(rounds);
+    if (idle_seconds)
+        return tickless(idle_seconds);
+    if (ticks)
+        return scaling(ticks);
+    if (pedal_seconds)
+        return pedals(pedal_seconds, noise);
+    if (presses)
+        return buttons(presses);
+    if (fields)
+        return formatter(fields);
+    if (records)
+        return telemetry(records);
+    if (samples)
+        return averager(samples);
+    if (vehicles)
+        return fleet(vehicles, steps ? steps : 20 * 3600);
+    if (steps)
+        return batch(steps);
+
+    double start = wall_clock();
+
+    sim::uart_tap(receive);
+
+    /* Declare an object of Controller Class */
+    Controller CarController;
+
+    /* Parked for a second, then drive */
+    sim::set_analog_noise(noise);
+    sim::set_analog(ACCELERATOR, accelerator);
+    sim::set_analog(BRAKE, brake);
+    flip(p5, 1, 1.0);
+    flip(p6, 1, 1.0);
+    flip(p7, 1, 60.0);
+    flip(p7, 0, 90.0);
+
+    /* Ask for the profiler and stack tables between two telemetry frames */
+    if (seconds > 15)
+        sim::schedule_irq((uint64_t)((seconds - 15) * 1e6), request_dumps, NULL);
+    sim::run_for(seconds);
+
+    double wall = wall_clock() - start;
+    double virt = sim::now_us() / 1e6;
+
+    printf("\n");
+    printf("LCD             |%s|\n", display.row(0));
+    printf("                |%s|\n", display.row(1));
+    /* The 6 odometer digits wrap at ODO_WRAP, the label stays put */
+    uint32_t driven = (uint32_t)CarController.getCar().getDistance();
+    printf("odometer        %u m driven, %u wraps, label %s\n", driven, driven / ODO_WRAP,
+           memcmp(display.row(1) + 6, "  m", 3) == 0 ? "intact" : "OVERWRITTEN");
+    printf("virtual time    %.1f s\n", virt);
+    printf("wall time       %.3f s (x%.0f)\n", wall, wall > 0 ? virt / wall : 0.0);
+    Executive &executive = CarController.getExecutive();
+    printf("schedule        minor %u ms, major %u ms, %u overruns, cpu %.2f%%\n",
+           executive.getMinorFrame(), executive.getMajorFrame(),
+           executive.getOverruns(), executive.cpuUsage() * 100.0f);
+    printf("  %-12s %8s %8s %10s %10s %10s %10s\n", "task", "period", "runs",
+           "jitter avg", "jitter max", "exec avg", "exec max");
+    for (int i = 0; i < executive.getTaskCount(); i++)
+    {
+        const TaskStats &t = executive.taskStats(i);
+        printf("  %-12s %8u %8u %10llu %10u %10llu %10u\n", t.name, t.period_ms, t.runs,
+               (unsigned long long)(t.runs ? t.total_jitter / t.runs : 0), t.max_jitter,
+               (unsigned long long)(t.runs ? t.total_exec / t.runs : 0), t.max_exec);
+    }
+    Profiler &profiler = CarController.getProfiler();
+    StackMonitor &stacks = CarController.getStacks();
+    printf("profiler        %d entries, stacks %d threads (host use), dump over serial:\n",
+           profiler.getCount(), stacks.getCount());
+    for (size_t pos = 0, end; (end = console.find('\n', pos)) != std::string::npos; pos = end + 1)
+        printf("  %s\n", console.substr(pos, end - pos - (end > pos && console[end - 1] == '\r')).c_str());
+    SwitchBank &switches = CarController.getSwitches();
+    printf("switches        %u changes, %u glitches, latency %u us avg, %u us max\n",
+           switches.getChanges(), switches.getGlitches(),
+           switches.getLatency(), switches.getMaxLatency());
+#if PEDAL_OVERSAMPLING
+    PedalSampler &sampler = CarController.getPedals();
+    printf("pedals          %u samples, accelerator %u (clean %u), brake %u (clean %u)\n",
+           sampler.getSamples(), sampler.getAccelerator(), (unsigned)(accelerator * 255),
+           sampler.getBrake(), (unsigned)(brake * 255));
+#endif
+    printf("context switch  %llu\n", (unsigned long long)sim::stats.context_switches);
+    printf("wake-ups        %llu\n", (unsigned long long)sim::stats.wakeups);
+    printf("busy wait       %.3f s\n", sim::stats.busy_us / 1e6);
+    printf("i2c             %llu transactions, %llu bytes\n",
+           (unsigned long long)sim::stats.i2c_transactions,
+           (unsigned long long)sim::stats.i2c_bytes);
+    MCP23017 *port = CarController.getPort();
+    printf("mcp23017        %u transactions, %u reads avoided, %u writes avoided\n",
+           port->get_transactions(), port->get_reads_avoided(),
+           port->get_writes_avoided());
+    printf("lcd             %u commands, %u characters\n",
+           display.commands(), display.characters());
+    WattBob_TextLCD *lcd = CarController.getLCD();
+    printf("lcd latency     %d us/char avg, %d us max, clear %d us\n",
+           lcd->charLatency(), lcd->charLatencyMax(), lcd->clearLatency());
+    LCDQueue *queue = CarController.getDisplay();
+    printf("lcd queue       %u refreshes, depth %u (max %u), %u dropped, latency %u us avg, %u us max\n",
+           queue->getRefreshes(), queue->getDepth(), queue->getMaxDepth(),
+           queue->getDropped(), queue->getLatency(), queue->getMaxLatency());
+    printf("uart            %llu bytes, %.3f s blocked\n",
+           (unsigned long long)sim::stats.uart_bytes,
+           sim::stats.uart_wait_us / 1e6);
+    TelemetryRing<message, TELEMETRY_SIZE> &telemetry = CarController.getTelemetry();
+    printf("telemetry       %u queued, %u dropped, high water %u of %u\n",
+           telemetry.size(), telemetry.getDropped(), telemetry.getHighWater(),
+           telemetry.capacity());
+    printf("link            %u frames, %u errors, %u lost\n",
+           receiver.getFrames(), receiver.getErrors(), receiver.getLost());
+    AsyncSerial &serial = CarController.getSerial();
+    printf("serial tx       %u bytes overflowed, high water %u of %u\n",
+           serial.getOverflows(), serial.getHighWater(), ASYNC_SERIAL_BUFFER);
+    fflush(stdout);
+
+    // Worker threads never return, leave without unwinding them
+    _exit(0);
+}
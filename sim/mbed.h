@@ -0,0 +1,295 @@
+//************************************************************************
+//
+//  mbed.h
+//
+//  Host build only.
+//
+//  Stand-ins for the parts of the mbed library used by the application
+//  and its drivers. Pins read from and write to the simulated board in
+//  sim.h; blocking calls (wait, I2C and UART transfers) advance the
+//  virtual clock instead of burning host time.
+//
+//************************************************************************
+#ifndef __SIM_MBED_H__
+#define __SIM_MBED_H__
+
+/* Standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* Simulator includes */
+#include "sim.h"
+#include "Stream.h"
+#include "us_ticker_api.h"
+
+/* LPC1768 DIP pins plus the on-board LEDs and USB serial */
+typedef enum {
+    p5 = 5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15, p16, p17, p18,
+    p19, p20, p21, p22, p23, p24, p25, p26, p27, p28, p29, p30,
+    LED1 = 40, LED2, LED3, LED4,
+    USBTX = 50, USBRX,
+    NC = -1
+} PinName;
+
+typedef enum {
+    PullUp = 0,
+    PullDown = 3,
+    PullNone = 2,
+    OpenDrain = 4,
+    PullDefault = PullDown
+} PinMode;
+
+/* wait_api.h */
+void wait(float s);
+void wait_ms(int ms);
+void wait_us(int us);
+
+namespace mbed {
+
+/*  Digital input */
+class DigitalIn
+{
+    public:
+        DigitalIn(PinName pin) : _pin(pin) {}
+        DigitalIn(PinName pin, PinMode mode) : _pin(pin) { (void)mode; }
+        int read() { return sim::get_digital(_pin); }
+        void mode(PinMode pull) { (void)pull; }
+        operator int() { return read(); }
+    protected:
+        PinName _pin;
+};
+
+/*  Digital output */
+class DigitalOut
+{
+    public:
+        DigitalOut(PinName pin) : _pin(pin) { write(0); }
+        DigitalOut(PinName pin, int value) : _pin(pin) { write(value); }
+        void write(int value) { sim::set_digital(_pin, value ? 1 : 0); }
+        int read() { return sim::get_digital(_pin); }
+        DigitalOut& operator= (int value) { write(value); return *this; }
+        DigitalOut& operator= (DigitalOut& rhs) { write(rhs.read()); return *this; }
+        operator int() { return read(); }
+    protected:
+        PinName _pin;
+};
+
+/*  Analog input, 12-bit converter scaled like the LPC1768 HAL */
+class AnalogIn
+{
+    public:
+        AnalogIn(PinName pin) : _pin(pin) {}
+        float read();
+        unsigned short read_u16();
+        operator float() { return read(); }
+    protected:
+        PinName _pin;
+};
+
+/*  PWM output */
+class PwmOut
+{
+    public:
+        PwmOut(PinName pin) : _pin(pin), _period(0.02f), _pulse(0.0f) {}
+        void write(float value) { pulsewidth(_period * value); }
+        float read() { return _period > 0 ? _pulse / _period : 0.0f; }
+        void period(float seconds) { _period = seconds; }
+        void period_ms(int ms) { period(ms / 1000.0f); }
+        void period_us(int us) { period(us / 1000000.0f); }
+        void pulsewidth(float seconds) { _pulse = seconds; sim::set_pulsewidth(_pin, seconds); }
+        void pulsewidth_ms(int ms) { pulsewidth(ms / 1000.0f); }
+        void pulsewidth_us(int us) { pulsewidth(us / 1000000.0f); }
+        PwmOut& operator= (float value) { write(value); return *this; }
+        operator float() { return read(); }
+    protected:
+        PinName _pin;
+        float _period;
+        float _pulse;
+};
+
+/*  I2C master, blocking transfers timed at the bus frequency */
+class I2C
+{
+    public:
+        I2C(PinName sda, PinName scl) : _hz(100000) { (void)sda; (void)scl; }
+        void frequency(int hz) { _hz = hz; }
+        int read(int address, char *data, int length, bool repeated = false)
+        {
+            (void)repeated;
+            return sim::i2c_read(address, data, length, _hz);
+        }
+        int write(int address, const char *data, int length, bool repeated = false)
+        {
+            (void)repeated;
+            return sim::i2c_write(address, data, length, _hz);
+        }
+    protected:
+        int _hz;
+};
+
+/*  Timer on the virtual clock */
+class Timer
+{
+    public:
+        Timer() : _running(false), _start(0), _time(0) {}
+        void start();
+        void stop();
+        void reset();
+        float read();
+        int read_ms();
+        int read_us();
+        operator float() { return read(); }
+    protected:
+        uint64_t elapsed();
+        bool _running;
+        uint64_t _start;
+        uint64_t _time;
+};
+
+/*  Callback to a function or a member function, like mbed's */
+class FunctionPointer
+{
+    public:
+        FunctionPointer() : _function(NULL), _object(NULL), _caller(NULL) {}
+        void attach(void (*function)(void))
+        {
+            _function = function;
+            _object = NULL;
+        }
+        template<typename T>
+        void attach(T *object, void (T::*member)(void))
+        {
+            _object = object;
+            memcpy(_member, (char*)&member, sizeof(member));
+            _caller = &FunctionPointer::memberCaller<T>;
+            _function = NULL;
+        }
+        void call()
+        {
+            if (_function)
+                _function();
+            else if (_object)
+                _caller(_object, _member);
+        }
+    private:
+        template<typename T>
+        static void memberCaller(void *object, char *member)
+        {
+            T *o = (T*)object;
+            void (T::*m)(void);
+            memcpy((char*)&m, member, sizeof(m));
+            (o->*m)();
+        }
+        void (*_function)(void);
+        void *_object;
+        char _member[16];
+        void (*_caller)(void *, char *);
+};
+
+/*  Periodic interrupt on the simulated timeline */
+class Ticker
+{
+    public:
+        Ticker() : _period(0), _next(0), _handle(0) {}
+        ~Ticker() { detach(); }
+        void attach(void (*fptr)(void), float t) { _fn.attach(fptr); start(t * 1e6f); }
+        template<typename T>
+        void attach(T *tptr, void (T::*mptr)(void), float t) { _fn.attach(tptr, mptr); start(t * 1e6f); }
+        void attach_us(void (*fptr)(void), unsigned int t) { _fn.attach(fptr); start(t); }
+        template<typename T>
+        void attach_us(T *tptr, void (T::*mptr)(void), unsigned int t) { _fn.attach(tptr, mptr); start(t); }
+        void detach();
+    private:
+        void start(uint64_t period_us);
+        static void tick(void *p);
+        FunctionPointer _fn;
+        uint64_t _period;
+        uint64_t _next;
+        uint64_t _handle;
+};
+
+/*  Edge interrupt on a digital pin, raised on the simulated timeline */
+class InterruptIn
+{
+    public:
+        InterruptIn(PinName pin);
+        ~InterruptIn();
+        int read() { return sim::get_digital(_pin); }
+        void mode(PinMode pull) { (void)pull; }
+        void rise(void (*fptr)(void)) { _rise.attach(fptr); }
+        template<typename T>
+        void rise(T *tptr, void (T::*mptr)(void)) { _rise.attach(tptr, mptr); }
+        void fall(void (*fptr)(void)) { _fall.attach(fptr); }
+        template<typename T>
+        void fall(T *tptr, void (T::*mptr)(void)) { _fall.attach(tptr, mptr); }
+        operator int() { return read(); }
+    private:
+        static void edge(void *p);
+        PinName _pin;
+        int _level;
+        FunctionPointer _rise;
+        FunctionPointer _fall;
+};
+
+/*  Serial port, 16-byte TX FIFO paced at the baud rate; a blocking
+ *  write waits once the FIFO is full, TxIrq fires when it drains */
+class SerialBase
+{
+    public:
+        enum IrqType {
+            RxIrq = 0,
+            TxIrq
+        };
+
+        void baud(int baudrate);
+        int readable();
+        int writeable();
+        void attach(void (*fptr)(void), IrqType type=RxIrq);
+        template<typename T>
+        void attach(T *tptr, void (T::*mptr)(void), IrqType type=RxIrq)
+        {
+            _irq[type].attach(tptr, mptr);
+            enable(type, tptr != NULL && mptr != NULL);
+        }
+    protected:
+        SerialBase(PinName tx, PinName rx);
+        int _base_putc(int c);
+        int _base_getc();
+    private:
+        void enable(IrqType type, bool on);
+        static void txInterrupt(void *p);
+        FunctionPointer _irq[2];
+};
+
+/*  Serial port with stdio formatting */
+class Serial : public SerialBase, public Stream
+{
+    public:
+        Serial(PinName tx, PinName rx, const char *name=NULL);
+    protected:
+        virtual int _putc(int c);
+        virtual int _getc();
+};
+
+/*  Serial port without stdio locking, the one usable from interrupts */
+class RawSerial : public SerialBase
+{
+    public:
+        RawSerial(PinName tx, PinName rx);
+        int putc(int c);
+        int getc();
+};
+
+/*  Interrupt mask, from the CMSIS core on target */
+inline void __disable_irq() { sim::irq_mask(true); }
+inline void __enable_irq() { sim::irq_mask(false); }
+
+}
+
+using namespace mbed;
+using namespace std;
+
+#endif
@@ -0,0 +1,199 @@
+//************************************************************************
+//
+//  rdybench.c
+//
+//  Host build only.
+//
+//  Ready list benchmark, see rdybench.h. Compiled as C against the RTX
+//  headers: the indexed path is rt_RdyMap.h itself, the linear path is
+//  the ready list branch of rt_put_prio and rt_get_first.
+//
+//************************************************************************
+
+/* Header includes */
+#include "rdybench.h"
+
+/* RTX includes, ahead of the standard headers that define NULL */
+#include "../mbed-rtos/rtx/TARGET_CORTEX_M/rt_TypeDef.h"
+
+#define RT_CLZ(x)       __builtin_clz(x)
+#include "../mbed-rtos/rtx/TARGET_CORTEX_M/rt_RdyMap.h"
+
+/* Standard includes */
+#include <time.h>
+
+static struct OS_TCB tcb[RDY_BENCH_TASKS];
+static struct OS_XCB head;
+static struct OS_RDYMAP rdy_index;
+
+/*  Monotonic clock */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*  Linear insert, the ready list branch of rt_put_prio */
+static void linear_put(P_XCB p_CB, P_TCB p_task)
+{
+    P_TCB p_CB2;
+    U32 prio;
+
+    prio = p_task->prio;
+    p_CB2 = p_CB->p_lnk;
+    while (p_CB2 != NULL && prio <= p_CB2->prio) {
+        p_CB = (P_XCB)p_CB2;
+        p_CB2 = p_CB2->p_lnk;
+    }
+    p_task->p_lnk = p_CB2;
+    p_CB->p_lnk = p_task;
+    p_task->p_rlnk = NULL;
+}
+
+/*  Head removal, the ready list branch of rt_get_first */
+static P_TCB linear_get(P_XCB p_CB)
+{
+    P_TCB p_first;
+
+    p_first = p_CB->p_lnk;
+    p_CB->p_lnk = p_first->p_lnk;
+    p_first->p_lnk = NULL;
+    return p_first;
+}
+
+/*  Indexed insert, rt_put_prio with OS_RDY_BITMAP */
+static void map_put(P_XCB p_CB, P_TCB p_task)
+{
+    rt_map_put(p_CB, &rdy_index, p_task);
+}
+
+/*  Indexed head removal, rt_get_first with OS_RDY_BITMAP */
+static P_TCB map_get(P_XCB p_CB)
+{
+    P_TCB p_first;
+
+    p_first = p_CB->p_lnk;
+    p_CB->p_lnk = p_first->p_lnk;
+    p_first->p_lnk = NULL;
+    rt_map_head_out(&rdy_index, p_first);
+    return p_first;
+}
+
+typedef void (*PutFn)(P_XCB, P_TCB);
+typedef P_TCB (*GetFn)(P_XCB);
+
+/*  One path */
+//  @param  order   wake-up order, one permutation per round
+//  @param  picked  filled with the dispatch order, one per round
+//  @param  ns      put, get and requeue totals
+//  @return checksum of the requeue dispatches
+static uint32_t run(PutFn put, GetFn get, uint32_t tasks, uint32_t rounds,
+                    const uint8_t *order, uint8_t *picked, uint64_t *ns)
+{
+    uint32_t i, r, sum = 0;
+    uint64_t t0, t1, t2;
+
+    ns[0] = ns[1] = ns[2] = 0;
+    head.p_lnk = NULL;
+    rdy_index.map = 0;
+    for (r = 0; r < rounds; r++)
+    {
+        const uint8_t *o = order + (r % 16) * tasks;
+        t0 = now_ns();
+        for (i = 0; i < tasks; i++)
+            put(&head, &tcb[o[i]]);
+        t1 = now_ns();
+        for (i = 0; i < tasks; i++)
+            picked[i] = get(&head)->task_id;
+        t2 = now_ns();
+        ns[0] += t1 - t0;
+        ns[1] += t2 - t1;
+        picked += tasks;
+    }
+
+    /* Round robin on a full list: the head goes back behind its peers */
+    for (i = 0; i < tasks; i++)
+        put(&head, &tcb[i]);
+    t0 = now_ns();
+    for (r = 0; r < rounds * tasks; r++)
+    {
+        P_TCB p = get(&head);
+        sum = sum * 31 + p->task_id;
+        put(&head, p);
+    }
+    ns[2] = now_ns() - t0;
+    return sum;
+}
+
+/*  Benchmarks one task count */
+//  @param  tasks   ready tasks, up to RDY_BENCH_TASKS
+//  @param  levels  distinct priorities, task i runs at 1 + i % levels
+//  @param  rounds  wake-up and dispatch rounds
+//  @param  result  times per operation, with the clock overhead removed
+void benchmarkReadyList(uint32_t tasks, uint32_t levels, uint32_t rounds,
+                        ReadyBenchmark *result)
+{
+    static uint8_t order[16 * RDY_BENCH_TASKS];
+    static uint8_t linear_picked[1 << 20];
+    static uint8_t map_picked[1 << 20];
+    uint64_t linear_ns[3], map_ns[3], t0, clock_ns;
+    uint32_t i, r, seed = 12345, linear_sum, map_sum;
+
+    if (tasks > RDY_BENCH_TASKS)
+        tasks = RDY_BENCH_TASKS;
+    if (rounds * tasks > sizeof(linear_picked))
+        rounds = sizeof(linear_picked) / tasks;
+
+    for (i = 0; i < tasks; i++)
+    {
+        tcb[i].cb_type = 0;
+        tcb[i].task_id = i;
+        tcb[i].prio = 1 + i % levels;
+    }
+
+    /* 16 shuffled wake-up orders */
+    for (r = 0; r < 16; r++)
+    {
+        uint8_t *o = order + r * tasks;
+        for (i = 0; i < tasks; i++)
+            o[i] = i;
+        for (i = tasks - 1; i > 0; i--)
+        {
+            uint32_t j;
+            uint8_t t;
+            seed = seed * 1103515245u + 12345u;
+            j = (seed >> 16) % (i + 1);
+            t = o[i];
+            o[i] = o[j];
+            o[j] = t;
+        }
+    }
+
+    /* Cost of one clock read */
+    t0 = now_ns();
+    for (r = 0; r < 1000; r++)
+        now_ns();
+    clock_ns = (now_ns() - t0) / 1000;
+
+    linear_sum = run(linear_put, linear_get, tasks, rounds, order, linear_picked, linear_ns);
+    map_sum = run(map_put, map_get, tasks, rounds, order, map_picked, map_ns);
+
+    result->tasks = tasks;
+    result->levels = levels;
+    result->rounds = rounds;
+    result->mismatches = linear_sum != map_sum;
+    for (i = 0; i < rounds * tasks; i++)
+        if (linear_picked[i] != map_picked[i])
+            result->mismatches++;
+
+#define PER_OP(total)   ((double)((total) > rounds * clock_ns ? (total) - rounds * clock_ns : 0) \
+                         / ((double)rounds * tasks))
+    result->linear_put = PER_OP(linear_ns[0]);
+    result->map_put = PER_OP(map_ns[0]);
+    result->linear_get = PER_OP(linear_ns[1]);
+    result->map_get = PER_OP(map_ns[1]);
+#undef PER_OP
+    result->linear_requeue = (double)linear_ns[2] / ((double)rounds * tasks);
+    result->map_requeue = (double)map_ns[2] / ((double)rounds * tasks);
+}
@@ -0,0 +1,49 @@
+//************************************************************************
+//
+//  rdybench.h
+//
+//  Host build only.
+//
+//  Benchmark of the RTX ready list: the linear walk of rt_put_prio
+//  against the priority index of rt_RdyMap.h (OS_RDY_BITMAP), on the
+//  same task control blocks and in the same order.
+//
+//  Functions:
+//          -benchmarkReadyList     times wake-ups, dispatches and
+//                                  requeues for one task count
+//
+//************************************************************************
+#ifndef __RDYBENCH_H__
+#define __RDYBENCH_H__
+
+#include <stdint.h>
+
+/* Largest task count benchmarked */
+#define RDY_BENCH_TASKS     64
+
+/* Benchmark results, times in host ns per operation */
+typedef struct {
+    uint32_t tasks;
+    uint32_t levels;
+    uint32_t rounds;
+    uint32_t mismatches;        // dispatches that picked different tasks
+    double linear_put;
+    double map_put;
+    double linear_get;
+    double map_get;
+    double linear_requeue;
+    double map_requeue;
+} ReadyBenchmark;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void benchmarkReadyList(uint32_t tasks, uint32_t levels, uint32_t rounds,
+                        ReadyBenchmark *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
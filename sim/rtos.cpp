@@ -0,0 +1,300 @@
+//************************************************************************
+//
+//  rtos.cpp
+//
+//  Host build only.
+//
+//  Simulated rtos::Thread, Semaphore and Mutex
+//
+//************************************************************************
+
+/* Header includes */
+#include "rtos.h"
+
+namespace rtos {
+
+/*------------------------------------------------------------------------
+ * Thread
+ */
+Thread::Thread(void (*task)(void const *argument), void *argument,
+               osPriority priority, uint32_t stack_size,
+               unsigned char *stack_pointer)
+{
+    (void)stack_pointer;
+    _overruns = 0;
+    _tid = sim::create(task, argument, priority, stack_size);
+}
+
+Thread::~Thread()
+{
+    terminate();
+}
+
+osStatus Thread::terminate()
+{
+    sim::terminate(_tid);
+    return osOK;
+}
+
+osStatus Thread::set_priority(osPriority priority)
+{
+    sim::set_priority(_tid, priority);
+    return osOK;
+}
+
+osPriority Thread::get_priority()
+{
+    return (osPriority)_tid->priority;
+}
+
+int32_t Thread::signal_set(int32_t signals)
+{
+    int32_t previous = _tid->signals;
+    _tid->signals |= signals;
+
+    if (_tid->state == sim::Task::SIGNAL)
+    {
+        int32_t wanted = _tid->wait_signals;
+        if ((wanted == 0 && _tid->signals) ||
+            (wanted != 0 && (_tid->signals & wanted) == wanted))
+            sim::wake(_tid);
+    }
+    return previous;
+}
+
+int32_t Thread::signal_clr(int32_t signals)
+{
+    _tid->signals &= ~signals;
+    return _tid->signals;
+}
+
+Thread::State Thread::get_state()
+{
+    switch (_tid->state)
+    {
+        case sim::Task::READY:      return Ready;
+        case sim::Task::RUNNING:    return Running;
+        case sim::Task::DELAY:      return WaitingDelay;
+        case sim::Task::INTERVAL:   return WaitingInterval;
+        case sim::Task::SEMAPHORE:  return WaitingSemaphore;
+        case sim::Task::SIGNAL:     return WaitingAnd;
+        case sim::Task::MAIL:       return WaitingMailbox;
+        case sim::Task::MUTEX:      return WaitingMutex;
+        default:                    return Inactive;
+    }
+}
+
+uint32_t Thread::stack_size()
+{
+    return _tid->stack_size;
+}
+
+uint32_t Thread::free_stack()
+{
+    return _tid->stack_size;
+}
+
+uint32_t Thread::used_stack()
+{
+    return 0;
+}
+
+uint32_t Thread::max_stack()
+{
+    return sim::stack_used(_tid);
+}
+
+/*  Periodic releases */
+//  @brief  same grid as rt_itv_set/rt_itv_wait: the next release is one
+//          interval after the previous one, a late thread catches up
+osStatus Thread::period_set(uint32_t millisec)
+{
+    if (millisec == 0)
+        return osErrorValue;
+    _overruns = 0;
+    _tid->interval_us = (uint64_t)millisec * 1000;
+    _tid->release_us = sim::now_us() + _tid->interval_us;
+    return osOK;
+}
+
+osStatus Thread::period_wait()
+{
+    if (_tid->interval_us == 0)
+        return osErrorResource;
+
+    uint64_t release = _tid->release_us;
+    _tid->release_us += _tid->interval_us;
+    if (release < sim::now_us())
+    {
+        _overruns++;
+        return osOK;
+    }
+    if (release > sim::now_us())
+        sim::block_until(sim::Task::INTERVAL, release);
+    return osEventTimeout;
+}
+
+uint32_t Thread::overruns()
+{
+    return _overruns;
+}
+
+osEvent Thread::signal_wait(int32_t signals, uint32_t millisec)
+{
+    sim::Task *self = sim::current();
+    osEvent evt;
+
+    for (;;)
+    {
+        bool ready = (signals == 0) ? (self->signals != 0)
+                                    : ((self->signals & signals) == signals);
+        if (ready)
+            break;
+        evt.status = (millisec == 0) ? osOK : osEventTimeout;
+        if (millisec == 0)
+            return evt;
+        self->wait_signals = signals;
+        if (!sim::block(sim::Task::SIGNAL, millisec))
+            return evt;
+    }
+
+    evt.status = osEventSignal;
+    evt.value.signals = self->signals;
+    self->signals &= (signals == 0) ? 0 : ~signals;
+    return evt;
+}
+
+osStatus Thread::wait(uint32_t millisec)
+{
+    sim::block(sim::Task::DELAY, millisec);
+    return osEventTimeout;
+}
+
+osStatus Thread::yield()
+{
+    sim::yield();
+    return osOK;
+}
+
+osThreadId Thread::gettid()
+{
+    return sim::current();
+}
+
+/*------------------------------------------------------------------------
+ * Semaphore
+ */
+Semaphore::Semaphore(int32_t count)
+: _count(count)
+{
+}
+
+int32_t Semaphore::wait(uint32_t millisec)
+{
+    if (_count > 0)
+        return _count--;
+    if (millisec == 0 || sim::in_irq())
+        return 0;
+
+    sim::Task *self = sim::current();
+    _waiters.push_back(self);
+    self->queue = &_waiters;
+
+    // The releasing task hands its token over directly
+    if (sim::block(sim::Task::SEMAPHORE, millisec))
+        return _count + 1;
+    return 0;
+}
+
+osStatus Semaphore::release(void)
+{
+    if (!_waiters.empty())
+    {
+        sim::Task *task = _waiters.front();
+        _waiters.pop_front();
+        task->queue = NULL;
+        sim::wake(task);
+    }
+    else
+        _count++;
+    return osOK;
+}
+
+/*------------------------------------------------------------------------
+ * Mutex
+ */
+Mutex::Mutex()
+: _owner(NULL),
+  _level(0)
+{
+}
+
+osStatus Mutex::lock(uint32_t millisec)
+{
+    sim::Task *self = sim::current();
+
+    if (_owner == NULL || _owner == self)
+    {
+        _owner = self;
+        _level++;
+        return osOK;
+    }
+    if (millisec == 0)
+        return osErrorResource;
+
+    _waiters.push_back(self);
+    self->queue = &_waiters;
+    if (sim::block(sim::Task::MUTEX, millisec))
+        return osOK;
+    return osErrorTimeoutResource;
+}
+
+bool Mutex::trylock()
+{
+    return lock(0) == osOK;
+}
+
+osStatus Mutex::unlock()
+{
+    if (_owner != sim::current())
+        return osErrorResource;
+    if (--_level > 0)
+        return osOK;
+
+    _owner = NULL;
+    if (!_waiters.empty())
+    {
+        sim::Task *task = _waiters.front();
+        _waiters.pop_front();
+        task->queue = NULL;
+        _owner = task;
+        _level = 1;
+        sim::wake(task);
+    }
+    return osOK;
+}
+
+}
+
+/*------------------------------------------------------------------------
+ * Stack usage (mbed extension)
+ */
+osThreadId osThreadGetIdleId()
+{
+    return NULL;
+}
+
+osThreadId osThreadGetTimerId()
+{
+    return NULL;
+}
+
+uint32_t osThreadStackSize(osThreadId thread_id)
+{
+    return thread_id ? thread_id->stack_size : 0;
+}
+
+uint32_t osThreadStackMax(osThreadId thread_id)
+{
+    return thread_id ? sim::stack_used(thread_id) : 0;
+}
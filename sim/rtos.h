@@ -0,0 +1,190 @@
+//************************************************************************
+//
+//  rtos.h
+//
+//  Host build only.
+//
+//  Stand-ins for the mbed-rtos Thread, Semaphore, Mutex and Mail classes,
+//  with the same interface as mbed-rtos/rtos, running on the virtual-time
+//  kernel in sim.h.
+//
+//************************************************************************
+#ifndef __SIM_RTOS_H__
+#define __SIM_RTOS_H__
+
+/* Kernel includes */
+#include "cmsis_os.h"
+#include "sim.h"
+
+/* Standard includes */
+#include <string.h>
+
+#include <deque>
+
+namespace rtos {
+
+/*  Thread */
+class Thread
+{
+    public:
+        enum State {
+            Inactive,
+            Ready,
+            Running,
+            WaitingDelay,
+            WaitingInterval,
+            WaitingOr,
+            WaitingAnd,
+            WaitingSemaphore,
+            WaitingMailbox,
+            WaitingMutex,
+        };
+
+        Thread(void (*task)(void const *argument), void *argument=NULL,
+               osPriority priority=osPriorityNormal,
+               uint32_t stack_size=DEFAULT_STACK_SIZE,
+               unsigned char *stack_pointer=NULL);
+
+        osStatus terminate();
+        osStatus set_priority(osPriority priority);
+        osPriority get_priority();
+        int32_t signal_set(int32_t signals);
+        int32_t signal_clr(int32_t signals);
+        State get_state();
+        uint32_t stack_size();
+        uint32_t free_stack();
+        uint32_t used_stack();
+        uint32_t max_stack();
+
+        osStatus period_set(uint32_t millisec);
+        osStatus period_wait();
+        uint32_t overruns();
+
+        static osEvent signal_wait(int32_t signals, uint32_t millisec=osWaitForever);
+        static osStatus wait(uint32_t millisec);
+        static osStatus yield();
+        static osThreadId gettid();
+
+        virtual ~Thread();
+
+    private:
+        osThreadId _tid;
+        uint32_t _overruns;
+};
+
+/*  Counting semaphore */
+class Semaphore
+{
+    public:
+        Semaphore(int32_t count);
+
+        int32_t wait(uint32_t millisec=osWaitForever);
+        osStatus release(void);
+
+    private:
+        int32_t _count;
+        std::deque<sim::Task*> _waiters;
+};
+
+/*  Recursive mutex */
+class Mutex
+{
+    public:
+        Mutex();
+
+        osStatus lock(uint32_t millisec=osWaitForever);
+        bool trylock();
+        osStatus unlock();
+
+    private:
+        sim::Task *_owner;
+        int _level;
+        std::deque<sim::Task*> _waiters;
+};
+
+/*  Mail queue */
+//  @brief  fixed pool of queue_sz blocks of type T plus a FIFO of
+//          posted blocks, same semantics as the RTX mail queue
+template<typename T, uint32_t queue_sz>
+class Mail
+{
+    public:
+        Mail() : _free_count(queue_sz)
+        {
+            for (uint32_t i = 0; i < queue_sz; i++)
+                _free[i] = &_pool[i];
+        }
+
+        T* alloc(uint32_t millisec=0)
+        {
+            (void)millisec;
+            if (_free_count == 0)
+                return NULL;
+            return _free[--_free_count];
+        }
+
+        T* calloc(uint32_t millisec=0)
+        {
+            T *mptr = alloc(millisec);
+            if (mptr)
+                memset((void*)mptr, 0, sizeof(T));
+            return mptr;
+        }
+
+        osStatus put(T *mptr)
+        {
+            if (mptr == NULL)
+                return osErrorParameter;
+            _queue.push_back(mptr);
+            if (!_waiters.empty())
+            {
+                sim::Task *task = _waiters.front();
+                _waiters.pop_front();
+                task->queue = NULL;
+                sim::wake(task);
+            }
+            return osOK;
+        }
+
+        osEvent get(uint32_t millisec=osWaitForever)
+        {
+            osEvent evt;
+            evt.def.mail_id = this;
+            while (_queue.empty())
+            {
+                evt.status = (millisec == 0) ? osOK : osEventTimeout;
+                if (millisec == 0 || sim::in_irq())
+                    return evt;
+                sim::Task *self = sim::current();
+                _waiters.push_back(self);
+                self->queue = &_waiters;
+                if (!sim::block(sim::Task::MAIL, millisec))
+                    return evt;
+            }
+            evt.status = osEventMail;
+            evt.value.p = _queue.front();
+            _queue.pop_front();
+            return evt;
+        }
+
+        osStatus free(T *mptr)
+        {
+            if (mptr == NULL || _free_count == queue_sz)
+                return osErrorParameter;
+            _free[_free_count++] = mptr;
+            return osOK;
+        }
+
+    private:
+        T _pool[queue_sz];
+        T *_free[queue_sz];
+        uint32_t _free_count;
+        std::deque<T*> _queue;
+        std::deque<sim::Task*> _waiters;
+};
+
+}
+
+using namespace rtos;
+
+#endif
@@ -0,0 +1,286 @@
+//************************************************************************
+//
+//  sim.h
+//
+//  Host build only.
+//
+//  Virtual-time kernel and simulated board used by the host build.
+//
+//  Every rtos::Thread is a coroutine (ucontext) scheduled on one host
+//  thread. Only one task runs at a time; blocking calls (Thread::wait,
+//  Semaphore::wait, Mail::get, ...) hand over to the next ready task and,
+//  when none is ready, the virtual clock jumps straight to the next
+//  wake-up or simulated interrupt. Busy waits (wait(), wait_us(), blocking
+//  I2C and UART transfers) advance the clock in place.
+//
+//  Board side: the pin table behind DigitalIn/DigitalOut/AnalogIn/PwmOut,
+//  an I2C bus with pluggable device models, the MCP23017 expander and the
+//  HD44780 display found on the WattBob board.
+//
+//************************************************************************
+#ifndef __SIM_H__
+#define __SIM_H__
+
+#include <stdint.h>
+#include <ucontext.h>
+
+#include <deque>
+
+namespace sim {
+
+/* Pin names double as indexes in the pin table */
+enum { PIN_COUNT = 64 };
+
+/*  Simulated task */
+struct Task
+{
+    enum State { READY, RUNNING, DELAY, INTERVAL, SEMAPHORE, SIGNAL, MAIL, MUTEX, INACTIVE };
+
+    ucontext_t ctx;
+    char *stack;
+    uint32_t stack_size;
+    void (*fn)(void const *);
+    void *arg;
+    int priority;
+    State state;
+
+    /* Timed wake-up, 0 when not armed */
+    uint64_t timer_key;
+    bool timed_out;
+
+    /* Periodic releases (rt_itv_set/rt_itv_wait), 0 when not set */
+    uint64_t interval_us;
+    uint64_t release_us;
+
+    /* Wait queue the task is parked on, if any */
+    std::deque<Task*> *queue;
+
+    /* Signal flags */
+    int32_t signals;
+    int32_t wait_signals;
+};
+
+/* Interrupt callback run on the virtual timeline */
+typedef void (*irq_fn)(void *arg);
+
+/*------------------------------------------------------------------------
+ * Kernel
+ */
+
+/* Current virtual time in microseconds */
+uint64_t now_us();
+
+/* Running task (the main() context before any thread blocks) */
+Task *current();
+
+/* True while a simulated interrupt handler is running */
+bool in_irq();
+
+/* Create a task, ready to run once the caller blocks */
+Task *create(void (*fn)(void const *), void *arg, int priority, uint32_t stack_size);
+
+/* Deepest use of the host stack of a task, in bytes */
+uint32_t stack_used(Task *task);
+
+/* Make a blocked task ready, preempting the caller if it has lower priority */
+void wake(Task *task);
+
+/* Remove a task from the scheduler for good */
+void terminate(Task *task);
+
+/* Change the priority of a task, re-queueing it if ready */
+void set_priority(Task *task, int priority);
+
+/* Block the running task; returns false if the timeout expired first */
+bool block(Task::State state, uint32_t timeout_ms);
+
+/* Block the running task until an absolute virtual time */
+void block_until(Task::State state, uint64_t at_us);
+
+/* Move the running task to the back of its priority level */
+void yield();
+
+/* Advance the clock in place, servicing any interrupt that falls due */
+void busy(uint64_t us);
+
+/* Schedule an interrupt callback; returns a handle for cancel() */
+uint64_t schedule_irq(uint64_t at_us, irq_fn fn, void *arg);
+void cancel_irq(uint64_t handle);
+
+/* Global interrupt mask (__disable_irq/__enable_irq): pending events
+ * wait until the mask is cleared */
+void irq_mask(bool masked);
+
+/* Block main() for the given amount of virtual time */
+void run_for(double seconds);
+
+/*------------------------------------------------------------------------
+ * Statistics
+ */
+struct Stats
+{
+    uint64_t context_switches;
+    uint64_t wakeups;
+    uint64_t irqs;
+    uint64_t busy_us;
+    uint64_t i2c_transactions;
+    uint64_t i2c_bytes;
+    uint64_t uart_bytes;
+    uint64_t uart_wait_us;
+};
+
+extern Stats stats;
+
+/*------------------------------------------------------------------------
+ * Pins
+ */
+void set_digital(int pin, int value);
+int  get_digital(int pin);
+void set_analog(int pin, float value);
+float get_analog(int pin);
+
+/* Gaussian noise added to every conversion, sigma as a fraction of
+ * full scale; 0 (default) for clean conversions */
+void set_analog_noise(float sigma);
+
+/* Level seen by one conversion: the pin level plus noise */
+float sample_analog(int pin);
+void set_pulsewidth(int pin, float seconds);
+float get_pulsewidth(int pin);
+
+/* Interrupt raised on every change of a digital pin; NULL disables it */
+void pin_irq(int pin, irq_fn fn, void *arg);
+
+/*------------------------------------------------------------------------
+ * UART
+ */
+
+/* Line rate set through Serial::baud() */
+void uart_baud(int baud);
+
+/* Echo everything written to the simulated UART on stdout */
+void uart_echo(bool on);
+
+/* Time to shift one character out, at the current baud rate */
+uint64_t uart_char_us();
+
+/* Account a character written through a blocking putc */
+void uart_put(int c);
+
+/* Receiver on the far end of the line, called for every character */
+void uart_tap(void (*receiver)(int c));
+
+/* Character sent by the far end, read back through Serial::getc() */
+void uart_rx(int c);
+
+/* Characters received and not yet read */
+int uart_rx_count();
+
+/* Next received character, -1 if none */
+int uart_rx_get();
+
+/* Room left in the TX FIFO */
+int uart_space();
+
+/* TX empty interrupt, raised when the FIFO drains; NULL disables it */
+void uart_tx_irq(irq_fn fn, void *arg);
+
+/*------------------------------------------------------------------------
+ * I2C
+ */
+
+/* Device sitting on the simulated bus at an 8-bit address */
+class I2CDevice
+{
+    public:
+        I2CDevice(int address);
+        virtual ~I2CDevice();
+        virtual int write(const char *data, int length) = 0;
+        virtual int read(char *data, int length) = 0;
+        int address() const { return _address; }
+    private:
+        int _address;
+};
+
+/* Dispatch a transfer to the device at address; returns 0 on ACK */
+int i2c_write(int address, const char *data, int length, int hz);
+int i2c_read(int address, char *data, int length, int hz);
+
+/*------------------------------------------------------------------------
+ * HD44780 text display, 4-bit interface
+ */
+class Hd44780
+{
+    public:
+        Hd44780();
+
+        /* Feed the control and data lines; acts on the falling edge of E */
+        void update(bool rs, bool rw, bool e, int data);
+
+        /* Nibble driven on D4-D7 during a read (RW and E high), -1 when
+         * the display is not driving: busy flag on D7 of the first nibble */
+        int bus() const;
+
+        /* Visible text of a row (16 characters) */
+        const char *row(int r);
+
+        /* Instructions and characters received */
+        uint32_t commands() const { return _commands; }
+        uint32_t characters() const { return _characters; }
+
+    private:
+        void execute(bool rs, int value);
+
+        char _ddram[0x80];
+        char _row[17];
+        int  _address;
+        bool _four_bit;
+        bool _high_nibble;
+        int  _latched;
+        bool _e;
+        bool _rw;
+        bool _read_high;
+        uint64_t _busy_until;
+        uint32_t _commands;
+        uint32_t _characters;
+};
+
+/*------------------------------------------------------------------------
+ * MCP23017 16-bit I/O expander, IOCON.BANK = 0 register map
+ */
+class Mcp23017 : public I2CDevice
+{
+    public:
+        Mcp23017(int address, Hd44780 *lcd);
+
+        virtual int write(const char *data, int length);
+        virtual int read(char *data, int length);
+
+        /* Level driven on the pins by the outside world */
+        void set_inputs(uint16_t levels);
+        uint16_t inputs() const { return _inputs; }
+
+        /* Pin driven by INTA, idle until an enabled input changes */
+        void connect_int(int pin);
+
+        uint8_t reg(int address) const { return _reg[address]; }
+
+    private:
+        uint16_t gpio();
+        uint16_t reg16(int address) const;
+        void next();
+        void outputs_changed();
+        void interrupts();
+        void drive_int();
+
+        uint8_t  _reg[0x16];
+        int      _pointer;
+        uint16_t _inputs;
+        uint16_t _previous;
+        int      _int_pin;
+        Hd44780 *_lcd;
+};
+
+}
+
+#endif
@@ -0,0 +1,18 @@
+//************************************************************************
+//
+//  us_ticker_api.h
+//
+//  Host build only.
+//
+//  Microsecond ticker on the virtual clock, wraps like the 32-bit timer
+//  on target.
+//
+//************************************************************************
+#ifndef __SIM_US_TICKER_API_H__
+#define __SIM_US_TICKER_API_H__
+
+#include <stdint.h>
+
+uint32_t us_ticker_read(void);
+
+#endif
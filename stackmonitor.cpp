@@ -0,0 +1,188 @@
+//************************************************************************
+//
+//  stackmonitor.cpp
+//
+//  StackMonitor Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "stackmonitor.h"
+
+/* Formatting includes */
+#include "format.h"
+
+/* Standard includes */
+#include <string.h>
+
+/* Column widths of a dumped line */
+#define NAME_WIDTH      12
+
+/*  Default Constructor */
+//  @param  period_ms   sampling period, only used to report times
+StackMonitor::StackMonitor(uint32_t period_ms)
+: count(0),
+  period_ms(period_ms),
+  samples(0)
+{
+}
+
+/*  Adds a thread */
+//  @param  name        thread name used in reports, not copied
+//  @param  thread      started thread, its stack filled at creation
+//  @return entry id, -1 if the table is full
+int StackMonitor::add(const char *name, Thread &thread)
+{
+    if (count == STACK_MAX_ENTRIES)
+        return -1;
+
+    StackEntry &e = entries[count];
+    e.name = name;
+    e.thread = &thread;
+    e.id = NULL;
+    e.size = thread.stack_size();
+    e.max_used = thread.max_stack();
+    e.peak_sample = samples;
+    return count++;
+}
+
+/*  Adds an RTX thread */
+//  @param  name        thread name used in reports, not copied
+//  @param  id          thread with a filled stack, NULL is ignored
+//  @return entry id, -1 if the table is full or id is NULL
+int StackMonitor::add(const char *name, osThreadId id)
+{
+    if (count == STACK_MAX_ENTRIES || id == NULL)
+        return -1;
+
+    StackEntry &e = entries[count];
+    e.name = name;
+    e.thread = NULL;
+    e.id = id;
+    e.size = osThreadStackSize(id);
+    e.max_used = osThreadStackMax(id);
+    e.peak_sample = samples;
+    return count++;
+}
+
+/*  Adds the RTX system threads */
+//  @brief  idle thread, and the timer thread when user timers are
+//          configured
+//
+//  N.B.: the timer thread exists once the kernel runs, so not from
+//        static constructors
+void StackMonitor::addSystem()
+{
+    add("rtx idle", osThreadGetIdleId());
+    add("rtx timer", osThreadGetTimerId());
+}
+
+/*  Samples every entry */
+//  @brief  reads every mark and remembers the samples that moved one
+//
+//  N.B.: reads the stacks of other threads without a lock, the fill
+//        words only ever get overwritten
+void StackMonitor::sample()
+{
+    samples++;
+    for (int i = 0; i < count; i++)
+    {
+        StackEntry &e = entries[i];
+        uint32_t used = e.thread ? e.thread->max_stack() : osThreadStackMax(e.id);
+        if (used > e.max_used)
+        {
+            e.max_used = used;
+            e.peak_sample = samples;
+        }
+    }
+}
+
+/*  Standard Accessor */
+int StackMonitor::getCount()
+{
+    return count;
+}
+
+/*  Standard Accessor */
+const StackEntry &StackMonitor::entry(int id)
+{
+    return entries[id];
+}
+
+/*  Standard Accessor */
+uint32_t StackMonitor::getPeriod()
+{
+    return period_ms;
+}
+
+/*  Standard Accessor */
+uint32_t StackMonitor::getSamples()
+{
+    return samples;
+}
+
+/*  Recommended stack size */
+//  @param  id      entry to size
+//  @return deepest use seen plus STACK_MARGIN percent, at least
+//          STACK_MARGIN_MIN bytes more, rounded up to 8 bytes (the
+//          alignment RTX gives the top of a stack)
+uint32_t StackMonitor::recommended(int id)
+{
+    uint32_t used = entries[id].max_used;
+    uint32_t margin = used * STACK_MARGIN / 100;
+    if (margin < STACK_MARGIN_MIN)
+        margin = STACK_MARGIN_MIN;
+    return (used + margin + 7) & ~7u;
+}
+
+/*  Column titles */
+//  @param  line    at least STACK_LINE characters
+//  @return characters written, terminated by CR LF
+//
+//  N.B.: sizes in bytes, peak is the uptime at which the mark last moved
+int StackMonitor::header(char *line)
+{
+    static const char titles[] =
+        "thread         size   used   free    rec  peak s\r\n";
+    memcpy(line, titles, sizeof(titles) - 1);
+    return sizeof(titles) - 1;
+}
+
+/*  Formats an entry */
+//  @param  id      entry to format
+//  @param  line    at least STACK_LINE characters
+//  @return characters written, terminated by CR LF; a '!' ends the
+//          line when the recommended size is larger than the stack
+//
+//  N.B.: no printf, safe to call from the executive thread
+int StackMonitor::format(int id, char *line)
+{
+    const StackEntry &e = entries[id];
+    uint32_t rec = recommended(id);
+    uint32_t headroom = e.size > e.max_used ? e.size - e.max_used : 0;
+    uint32_t peak_s = (uint32_t)((uint64_t)e.peak_sample * period_ms / 1000);
+
+    int pos = strlen(e.name);
+    if (pos > NAME_WIDTH)
+        pos = NAME_WIDTH;
+    memcpy(line, e.name, pos);
+    while (pos <= NAME_WIDTH)
+        line[pos++] = ' ';
+    pos += FixedField<6, ' '>::format(line + pos, e.size);
+    line[pos++] = ' ';
+    pos += FixedField<6, ' '>::format(line + pos, e.max_used);
+    line[pos++] = ' ';
+    pos += FixedField<6, ' '>::format(line + pos, headroom);
+    line[pos++] = ' ';
+    pos += FixedField<6, ' '>::format(line + pos, rec);
+    line[pos++] = ' ';
+    pos += FixedField<7, ' '>::format(line + pos, peak_s);
+    if (rec > e.size)
+    {
+        line[pos++] = ' ';
+        line[pos++] = '!';
+    }
+    line[pos++] = '\r';
+    line[pos++] = '\n';
+    return pos;
+}
@@ -0,0 +1,94 @@
+//************************************************************************
+//
+//  stackmonitor.h
+//
+//  Requirements: mbed.h, rtos.h, format.h
+//
+//  Defines a StackMonitor Class: a fixed-size table of the deepest stack
+//  use of every registered thread, with the stack size it would need.
+//
+//  Every mbed Thread fills its stack with a pattern when it is created,
+//  and RTX fills the idle and timer thread stacks the same way; the
+//  deepest use is where the pattern ends (Thread::max_stack,
+//  osThreadStackMax). The mark only ever moves down, so sampling it
+//  periodically loses nothing; a sample also records when each mark last
+//  moved, which tells whether a soak run has settled.
+//
+//  OS_STKCHECK only catches an overflow at a context switch, once the
+//  word below the stack is gone; the table shows the headroom left
+//  before that happens.
+//
+//  The main thread is not covered: its stack is shared with the heap and
+//  is not filled.
+//
+//  Methods:
+//          -add            registers a Thread
+//          -addSystem      registers the RTX idle and timer threads
+//          -sample         reads every mark
+//          -recommended    deepest use plus STACK_MARGIN, 8-byte aligned
+//          -format         one text line per entry, for serial dumps
+//
+//************************************************************************
+#ifndef __STACKMONITOR_H__
+#define __STACKMONITOR_H__
+
+/* Mbed & RTOS includes */
+#include "mbed.h"
+#include "rtos.h"
+
+/* Maximum number of entries in the table */
+#define STACK_MAX_ENTRIES       8
+
+/* Longest line written by format(), terminator included */
+#define STACK_LINE              64
+
+/* Default sampling period, ms */
+#define STACK_SAMPLE_MS         5000
+
+/* Headroom over the deepest use, in percent, and its floor in bytes:
+   one context frame, the 16 words a preempted thread stacks */
+#define STACK_MARGIN            25
+#define STACK_MARGIN_MIN        64
+
+/* Per entry statistics, in bytes */
+typedef struct {
+    const char *name;
+    Thread *thread;             // NULL for the RTX system threads
+    osThreadId id;              // RTX system threads only
+    uint32_t size;
+    uint32_t max_used;
+    uint32_t peak_sample;       // sample that last moved the mark
+} StackEntry;
+
+class StackMonitor
+{
+    public:
+        /* Default Constructor */
+        StackMonitor(uint32_t period_ms = STACK_SAMPLE_MS);
+
+        /* Table setup */
+        int add(const char *name, Thread &thread);
+        int add(const char *name, osThreadId id);
+        void addSystem();
+
+        /* Sampling */
+        void sample();
+
+        /* Report */
+        int getCount();
+        const StackEntry &entry(int id);
+        uint32_t getPeriod();
+        uint32_t getSamples();
+        uint32_t recommended(int id);
+        int header(char *line);
+        int format(int id, char *line);
+
+    protected:
+        /* Members */
+        StackEntry entries[STACK_MAX_ENTRIES];
+        int count;
+        uint32_t period_ms;
+        uint32_t samples;
+};
+
+#endif
@@ -0,0 +1,217 @@
+//************************************************************************
+//
+//  switches.cpp
+//
+//  SwitchBank Class
+//
+//************************************************************************
+
+/* Header includes */
+#include "switches.h"
+
+/* Mbed includes */
+#include "us_ticker_api.h"
+
+/* Signal starting the bank, above the per switch flags */
+#define SWITCH_START        (1 << SWITCH_MAX)
+
+/* Every per switch flag */
+#define SWITCH_ALL          (SWITCH_START - 1)
+
+/*  Default Constructor */
+//  @param  priority    priority of the bank thread, above the executive
+//                      so a change is handled within the debounce time
+//  @param  stack_size  stack of the bank thread, shared by all handlers
+//
+//  @brief  Creates the thread, which waits for start()
+SwitchBank::SwitchBank(osPriority priority, uint32_t stack_size)
+: count(0),
+  started(false),
+  last_edge(0),
+  changes(0),
+  glitches(0),
+  total_latency(0),
+  max_latency(0),
+  profiler(NULL),
+  profile(-1),
+  _thread(&SwitchBank::threadStarter, this, priority, stack_size)
+{
+}
+
+/*  Adds a switch */
+//  @param  pin         switch input, both edges are used
+//  @param  handler     called from the bank thread when the level changes
+//  @param  arg         argument passed to handler
+//  @return false if the bank is full or already started
+bool SwitchBank::addSwitch(InterruptIn *pin, void (*handler)(void const *p), void *arg)
+{
+    if (count == SWITCH_MAX || started)
+        return false;
+
+    Input &input = inputs[count];
+    input.bank = this;
+    input.index = count;
+    input.pin = pin;
+    input.handler = handler;
+    input.arg = arg;
+    input.level = pin->read();
+    input.waiting = false;
+    input.first_edge = 0;
+
+    count++;
+    return true;
+}
+
+/*  Starts the bank */
+//  @brief  hooks the edge interrupts; the thread applies the current
+//          levels once, then only runs on changes
+void SwitchBank::start()
+{
+    if (count == 0 || started)
+        return;
+    started = true;
+
+    for (int i = 0; i < count; i++)
+    {
+        inputs[i].pin->rise(&inputs[i], &Input::edge);
+        inputs[i].pin->fall(&inputs[i], &Input::edge);
+    }
+    _thread.signal_set(SWITCH_START);
+}
+
+/*  Edge interrupt */
+//  @brief  timestamps the edge and wakes the thread
+void SwitchBank::Input::edge()
+{
+    uint32_t now = us_ticker_read();
+    if (!waiting)
+    {
+        waiting = true;
+        first_edge = now;
+    }
+    bank->last_edge = now;
+    bank->_thread.signal_set(1 << index);
+}
+
+/*  Thread worker */
+//  @brief  sleeps until an edge, waits for the lines to be quiet for
+//          SWITCH_DEBOUNCE_MS, then dispatches the settled levels
+void SwitchBank::run()
+{
+    Thread::signal_wait(SWITCH_START);
+
+    for (int i = 0; i < count; i++)
+    {
+        inputs[i].level = inputs[i].pin->read();
+        inputs[i].handler(inputs[i].arg);
+    }
+
+    while(1)
+    {
+        osEvent evt = Thread::signal_wait(0);
+        int32_t pending = evt.value.signals;
+
+        // Every new edge restarts the quiet period
+        uint32_t quiet;
+        while ((quiet = us_ticker_read() - last_edge) < SWITCH_DEBOUNCE_MS * 1000)
+            Thread::wait((SWITCH_DEBOUNCE_MS * 1000 - quiet + 999) / 1000);
+
+        evt = Thread::signal_wait(0, 0);
+        if (evt.status == osEventSignal)
+            pending |= evt.value.signals;
+
+        for (int i = 0; i < count; i++)
+            if (pending & SWITCH_ALL & (1 << i))
+                dispatch(i);
+    }
+}
+
+/*  Runs a handler if the settled level differs */
+//  @param  index   switch that saw edges
+void SwitchBank::dispatch(int index)
+{
+    Input &input = inputs[index];
+
+    __disable_irq();
+    int level = input.pin->read();
+    uint32_t first_edge = input.first_edge;
+    input.waiting = false;
+    __enable_irq();
+
+    if (level == input.level)
+    {
+        glitches++;
+        return;
+    }
+    input.level = level;
+    if (profiler)
+    {
+        profiler->begin(profile);
+        input.handler(input.arg);
+        profiler->end(profile);
+    }
+    else
+        input.handler(input.arg);
+
+    uint32_t latency = us_ticker_read() - first_edge;
+    changes++;
+    total_latency += latency;
+    if (latency > max_latency)
+        max_latency = latency;
+}
+
+/*  Standard Accessor */
+//  @return level changes dispatched
+uint32_t SwitchBank::getChanges()
+{
+    return changes;
+}
+
+/*  Standard Accessor */
+//  @return edge bursts that settled back to the previous level
+uint32_t SwitchBank::getGlitches()
+{
+    return glitches;
+}
+
+/*  Standard Accessor */
+//  @return average first edge to handler end time in us
+uint32_t SwitchBank::getLatency()
+{
+    return changes ? (uint32_t)(total_latency / changes) : 0;
+}
+
+/*  Standard Accessor */
+//  @return worst first edge to handler end time in us
+uint32_t SwitchBank::getMaxLatency()
+{
+    return max_latency;
+}
+
+/*  Standard Accessor */
+//  @return bank thread, for its stack usage
+Thread &SwitchBank::getThread()
+{
+    return _thread;
+}
+
+/*  Attaches a Profiler */
+//  @param  profiler    table that gets a "switches" entry, timing every
+//                      handler dispatched on a change
+//
+//  N.B.: must be called before start()
+void SwitchBank::setProfiler(Profiler *profiler)
+{
+    if (started)
+        return;
+    profile = profiler->add("switches");
+    this->profiler = profiler;
+}
+
+/*  Thread static callback */
+//  @brief      Calls run method
+void SwitchBank::threadStarter(void const *p)
+{
+    SwitchBank *instance = (SwitchBank*)p;
+    instance->run();
+}
@@ -0,0 +1,102 @@
+//************************************************************************
+//
+//  switches.h
+//
+//  Requirements: rtos.h, mbed.h, profiler.h
+//
+//  Defines a SwitchBank Class: edge interrupts on a set of switch pins,
+//  debounced by a thread that only wakes when a switch moves.
+//
+//  Every pin gets an InterruptIn on both edges. The interrupt records
+//  the time of the edge and sets the switch's signal flag on the bank
+//  thread. The thread then waits until no edge has been seen for
+//  SWITCH_DEBOUNCE_MS, reads the settled levels and runs the handler of
+//  every switch whose level actually changed. Contact bounce collapses
+//  into one change; a glitch that settles back is ignored.
+//
+//  Methods:
+//          -addSwitch      registers a pin and its handler
+//          -start          runs every handler once, then waits on edges
+//          -getLatency     first edge to handler time, average and worst
+//          -setProfiler    records every handler run in a Profiler table
+//
+//  Threads:
+//          -_thread        debounces and dispatches, asleep while no
+//                          switch moves
+//
+//************************************************************************
+#ifndef __SWITCHES_H__
+#define __SWITCHES_H__
+
+/* Mbed & RTOS includes */
+#include "mbed.h"
+#include "rtos.h"
+
+/* Profiler includes */
+#include "profiler.h"
+
+/* One signal flag per switch */
+#define SWITCH_MAX          8
+
+/* Quiet time before a level is trusted */
+#define SWITCH_DEBOUNCE_MS  5
+
+class SwitchBank
+{
+    public:
+        /* Default Constructor */
+        SwitchBank(osPriority priority = osPriorityAboveNormal, uint32_t stack_size = 1024);
+
+        /* Static Callback to thread */
+        static void threadStarter(void const *p);
+
+        /* Setup */
+        bool addSwitch(InterruptIn *pin, void (*handler)(void const *p), void *arg);
+        void start();
+
+        /* Statistics */
+        uint32_t getChanges();
+        uint32_t getGlitches();
+        uint32_t getLatency();
+        uint32_t getMaxLatency();
+        Thread &getThread();
+        void setProfiler(Profiler *profiler);
+
+    private:
+        /* Thread worker */
+        void run();
+        void dispatch(int index);
+
+    protected:
+        /* A switch and its edge interrupt */
+        struct Input {
+            SwitchBank *bank;
+            int index;
+            InterruptIn *pin;
+            void (*handler)(void const *p);
+            void *arg;
+            int level;
+            volatile bool waiting;
+            volatile uint32_t first_edge;
+
+            void edge();
+        };
+        friend struct Input;
+
+        Input inputs[SWITCH_MAX];
+        int count;
+        bool started;
+        volatile uint32_t last_edge;
+
+        /* Statistics */
+        uint32_t changes;
+        uint32_t glitches;
+        uint64_t total_latency;
+        uint32_t max_latency;
+        Profiler *profiler;
+        int profile;
+
+        Thread _thread;
+};
+
+#endif
@@ -0,0 +1,314 @@
+//************************************************************************
+//
+//  telemetry.cpp
+//
+//  TelemetryEncoder and TelemetryDecoder Classes
+//
+//************************************************************************
+
+/* Header includes */
+#include "telemetry.h"
+
+/* Standard includes */
+#include <string.h>
+
+/* Field offsets */
+#define OFFSET_SEQUENCE     2
+#define OFFSET_COUNT        3
+#define OFFSET_TIMESTAMP    4
+#define OFFSET_LENGTH       8
+
+/*  CRC-16/CCITT */
+//  @brief  nibble-wise, a 16 entry table keeps flash usage low
+uint16_t telemetryCrc(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+/*  Default Constructor */
+TelemetryEncoder::TelemetryEncoder()
+: length(0),
+  sequence(0),
+  count(0),
+  timestamp(0)
+{
+}
+
+/*  Starts a frame */
+//  @param  timestamp   ms, stored in the header
+void TelemetryEncoder::begin(uint32_t timestamp)
+{
+    frame[0] = TELEMETRY_SYNC0;
+    frame[1] = TELEMETRY_SYNC1;
+    frame[OFFSET_SEQUENCE] = sequence++;
+    frame[OFFSET_TIMESTAMP] = timestamp;
+    frame[OFFSET_TIMESTAMP + 1] = timestamp >> 8;
+    frame[OFFSET_TIMESTAMP + 2] = timestamp >> 16;
+    frame[OFFSET_TIMESTAMP + 3] = timestamp >> 24;
+    length = TELEMETRY_HEADER;
+    count = 0;
+    this->timestamp = timestamp;
+}
+
+/*  Appends a record */
+//  @return false if the frame is full
+bool TelemetryEncoder::add(const message &record)
+{
+    if (full())
+        return false;
+
+    // The first record is sent against an all-zero one at frame time
+    if (count == 0)
+    {
+        last.speed = 0;
+        last.accelerator = 0;
+        last.brake = 0;
+        last.time = timestamp;
+    }
+
+    putValue((int32_t)(record.time - last.time));
+    putValue((unsigned char)record.speed - (unsigned char)last.speed);
+    putValue((unsigned char)record.accelerator - (unsigned char)last.accelerator);
+    putValue((unsigned char)record.brake - (unsigned char)last.brake);
+
+    last = record;
+    count++;
+    return true;
+}
+
+/*  Closes the frame */
+//  @return frame size in bytes, ready in data()
+uint32_t TelemetryEncoder::finish()
+{
+    uint32_t payload = length - TELEMETRY_HEADER;
+
+    frame[OFFSET_COUNT] = count;
+    frame[OFFSET_LENGTH] = payload;
+    frame[OFFSET_LENGTH + 1] = payload >> 8;
+
+    uint16_t crc = telemetryCrc(0xFFFF, frame + OFFSET_SEQUENCE, length - OFFSET_SEQUENCE);
+    frame[length++] = crc;
+    frame[length++] = crc >> 8;
+    return length;
+}
+
+/*  Standard Accessor */
+const uint8_t *TelemetryEncoder::data()
+{
+    return frame;
+}
+
+/*  Standard Accessor */
+uint32_t TelemetryEncoder::getCount()
+{
+    return count;
+}
+
+/*  Standard Accessor */
+bool TelemetryEncoder::full()
+{
+    return count == TELEMETRY_MAX_RECORDS;
+}
+
+/*  Writes a value */
+//  @param  delta   zigzag varint: 1 byte up to +-63, 2 up to +-8191
+void TelemetryEncoder::putValue(int32_t delta)
+{
+    uint32_t zigzag = delta < 0 ? ((uint32_t)(-delta) << 1) - 1 : (uint32_t)delta << 1;
+
+    while (zigzag >= 0x80)
+    {
+        frame[length++] = (zigzag & 0x7F) | 0x80;
+        zigzag >>= 7;
+    }
+    frame[length++] = zigzag;
+}
+
+/*  Default Constructor */
+TelemetryDecoder::TelemetryDecoder()
+: length(0),
+  expected(0),
+  count(0),
+  sequence(0),
+  timestamp(0),
+  frames(0),
+  errors(0),
+  lost(0)
+{
+}
+
+/*  Feeds a byte */
+//  @param  byte    next byte from the link
+//  @return true when a valid frame has been decoded
+//
+//  N.B.: a bad header or CRC drops the sync word only, the bytes after it
+//        are scanned again for the next one
+bool TelemetryDecoder::push(uint8_t byte)
+{
+    frame[length++] = byte;
+    return scan();
+}
+
+/*  Looks for a frame in the buffered bytes */
+//  @return true when a valid frame has been decoded
+//
+//  N.B.: the buffer always starts on a sync word, or is empty
+bool TelemetryDecoder::scan()
+{
+    while (length > 0)
+    {
+        if (frame[0] != TELEMETRY_SYNC0 || (length > 1 && frame[1] != TELEMETRY_SYNC1))
+        {
+            skip(1);
+            continue;
+        }
+        if (length < TELEMETRY_HEADER)
+            return false;
+
+        uint32_t payload = frame[OFFSET_LENGTH] | (frame[OFFSET_LENGTH + 1] << 8);
+        if (payload > TELEMETRY_MAX_PAYLOAD || frame[OFFSET_COUNT] > TELEMETRY_MAX_RECORDS)
+        {
+            errors++;
+            skip(1);
+            continue;
+        }
+        expected = TELEMETRY_HEADER + payload + 2;
+        if (length < expected)
+            return false;
+
+        if (decode())
+        {
+            skip(expected);
+            return true;
+        }
+        errors++;
+        skip(1);
+    }
+    return false;
+}
+
+/*  Drops buffered bytes */
+//  @param  bytes   from the start of the buffer
+void TelemetryDecoder::skip(uint32_t bytes)
+{
+    length -= bytes;
+    memmove(frame, frame + bytes, length);
+}
+
+/*  Decodes a complete frame */
+//  @return false on CRC or payload error
+bool TelemetryDecoder::decode()
+{
+    uint32_t end = expected - 2;
+    uint16_t crc = frame[end] | (frame[end + 1] << 8);
+    if (telemetryCrc(0xFFFF, frame + OFFSET_SEQUENCE, end - OFFSET_SEQUENCE) != crc)
+        return false;
+
+    uint32_t n = frame[OFFSET_COUNT];
+    uint32_t pos = TELEMETRY_HEADER;
+    uint32_t stamp = frame[OFFSET_TIMESTAMP] | (frame[OFFSET_TIMESTAMP + 1] << 8) |
+                     (frame[OFFSET_TIMESTAMP + 2] << 16) | ((uint32_t)frame[OFFSET_TIMESTAMP + 3] << 24);
+    uint32_t time = stamp;
+    int speed = 0, accelerator = 0, brake = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t delta[4];
+        for (int j = 0; j < 4; j++)
+            if (!getValue(pos, delta[j]) || pos > end)
+                return false;
+        time += delta[0];
+        speed += delta[1];
+        accelerator += delta[2];
+        brake += delta[3];
+        records[i].time = time;
+        records[i].speed = speed;
+        records[i].accelerator = accelerator;
+        records[i].brake = brake;
+    }
+    if (pos != end)
+        return false;
+
+    uint8_t seq = frame[OFFSET_SEQUENCE];
+    if (frames != 0)
+        lost += (uint8_t)(seq - sequence - 1);
+    sequence = seq;
+    timestamp = stamp;
+    count = n;
+    frames++;
+    return true;
+}
+
+/*  Reads a value */
+//  @param  pos     read position, advanced past the value
+//  @return false if the varint is malformed or runs past the frame
+bool TelemetryDecoder::getValue(uint32_t &pos, int32_t &value)
+{
+    uint32_t zigzag = 0;
+    for (int shift = 0; shift < 35 && pos < expected - 2; shift += 7)
+    {
+        uint8_t byte = frame[pos++];
+        zigzag |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            value = (zigzag & 1) ? -(int32_t)((zigzag - 1) >> 1) - 1 : (int32_t)(zigzag >> 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*  Standard Accessor */
+uint8_t TelemetryDecoder::getSequence()
+{
+    return sequence;
+}
+
+/*  Standard Accessor */
+uint32_t TelemetryDecoder::getTimestamp()
+{
+    return timestamp;
+}
+
+/*  Standard Accessor */
+uint32_t TelemetryDecoder::getCount()
+{
+    return count;
+}
+
+/*  Standard Accessor */
+const message &TelemetryDecoder::getRecord(uint32_t index)
+{
+    return records[index];
+}
+
+/*  Standard Accessor */
+//  @return frames decoded
+uint32_t TelemetryDecoder::getFrames()
+{
+    return frames;
+}
+
+/*  Standard Accessor */
+//  @return frames dropped for bad header, payload or CRC
+uint32_t TelemetryDecoder::getErrors()
+{
+    return errors;
+}
+
+/*  Standard Accessor */
+//  @return frames missing from the sequence numbers
+uint32_t TelemetryDecoder::getLost()
+{
+    return lost;
+}
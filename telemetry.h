@@ -0,0 +1,134 @@
+//************************************************************************
+//
+//  telemetry.h
+//
+//  Requirements: message.h
+//
+//  Defines the binary frame used on the serial link, with an encoder
+//  for the target and a byte-wise decoder for the receiving side.
+//
+//  Frame layout (multi-byte fields little endian):
+//          -sync           0xA5 0x5A
+//          -sequence       uint8, +1 per frame
+//          -count          uint8, records in the frame
+//          -timestamp      uint32, ms when the frame was built
+//          -length         uint16, payload bytes
+//          -payload        records
+//          -crc            uint16, CRC-16/CCITT of sequence..payload
+//
+//  Every record starts with its sampling time, as a difference from the
+//  frame timestamp for the first record (usually negative, records wait
+//  in the queue) and from the previous record after that. Then comes
+//  speed, accelerator and brake: as they are in the first record, the
+//  difference from the previous record in the following ones. Each value
+//  is zigzag encoded in a 7-bit varint, so a steady drive at one record
+//  every 5 s costs 5 bytes per record instead of the 13 of the former CSV
+//  line.
+//
+//  Classes:
+//          -TelemetryEncoder   builds one frame in a fixed buffer
+//          -TelemetryDecoder   resynchronizes on the sync word and
+//                              checks length and CRC; after a bad
+//                              frame it scans again from the byte after
+//                              its sync word, which may have been a
+//                              false one inside a real frame
+//
+//************************************************************************
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+/* Message includes */
+#include "message.h"
+
+/* Standard includes */
+#include <stdint.h>
+
+/* Records per frame */
+#define TELEMETRY_MAX_RECORDS   32
+
+/* Frame sizes: a record is a time difference of up to 5 varint bytes
+   and 3 value differences of up to 2 */
+#define TELEMETRY_HEADER        10
+#define TELEMETRY_MAX_RECORD    (5 + 3 * 2)
+#define TELEMETRY_MAX_PAYLOAD   (TELEMETRY_MAX_RECORDS * TELEMETRY_MAX_RECORD)
+#define TELEMETRY_MAX_FRAME     (TELEMETRY_HEADER + TELEMETRY_MAX_PAYLOAD + 2)
+
+/* Sync word */
+#define TELEMETRY_SYNC0         0xA5
+#define TELEMETRY_SYNC1         0x5A
+
+/*  CRC-16/CCITT */
+//  @param  crc     running value, 0xFFFF to start
+//  @return updated value
+uint16_t telemetryCrc(uint16_t crc, const uint8_t *data, uint32_t length);
+
+class TelemetryEncoder
+{
+    public:
+        /* Default Constructor */
+        TelemetryEncoder();
+
+        /* Frame building */
+        void begin(uint32_t timestamp);
+        bool add(const message &record);
+        uint32_t finish();
+
+        /* Standard Accessors */
+        const uint8_t *data();
+        uint32_t getCount();
+        bool full();
+
+    private:
+        void putValue(int32_t delta);
+
+    protected:
+        /* Members */
+        uint8_t frame[TELEMETRY_MAX_FRAME];
+        uint32_t length;
+        uint8_t sequence;
+        uint8_t count;
+        uint32_t timestamp;
+        message last;
+};
+
+class TelemetryDecoder
+{
+    public:
+        /* Default Constructor */
+        TelemetryDecoder();
+
+        /* Feeds one received byte, true when a frame is complete */
+        bool push(uint8_t byte);
+
+        /* Standard Accessors, valid after push returned true */
+        uint8_t getSequence();
+        uint32_t getTimestamp();
+        uint32_t getCount();
+        const message &getRecord(uint32_t index);
+
+        /* Link statistics */
+        uint32_t getFrames();
+        uint32_t getErrors();
+        uint32_t getLost();
+
+    private:
+        bool scan();
+        void skip(uint32_t bytes);
+        bool decode();
+        bool getValue(uint32_t &pos, int32_t &value);
+
+    protected:
+        /* Members */
+        uint8_t frame[TELEMETRY_MAX_FRAME];
+        uint32_t length;
+        uint32_t expected;
+        message records[TELEMETRY_MAX_RECORDS];
+        uint32_t count;
+        uint8_t sequence;
+        uint32_t timestamp;
+        uint32_t frames;
+        uint32_t errors;
+        uint32_t lost;
+};
+
+#endif